@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+long long bottom_up_tree(long long *left, long long *right, long long index, long long depth) {
+  if (depth <= 0) {
+    left[index] = -1;
+
+    right[index] = -1;
+
+    return index + 1;
+  }
+
+  long long next = index + 1;
+
+  left[index] = next;
+
+  next = bottom_up_tree(left, right, next, depth - 1);
+
+  right[index] = next;
+
+  return bottom_up_tree(left, right, next, depth - 1);
+}
+
+long long item_check(const long long *left, const long long *right, long long index) {
+  if (left[index] < 0) return 1;
+
+  return 1 + item_check(left, right, left[index]) + item_check(left, right, right[index]);
+}
+
+long long check_tree(long long depth) {
+  long long nodes = (1LL << (depth + 1)) - 1;
+  long long *left = calloc(nodes, sizeof(long long));
+  long long *right = calloc(nodes, sizeof(long long));
+
+  bottom_up_tree(left, right, 0, depth);
+
+  long long check = item_check(left, right, 0);
+
+  free(left);
+  free(right);
+
+  return check;
+}
+
+int main(int argc, char **argv) {
+  long long min_depth = 4, max_depth = 18;
+
+  if (argc > 1) max_depth = atoll(argv[1]);
+
+  long long stretch_depth = max_depth + 1;
+
+  printf("stretch tree of depth %lli check: %lli\n", stretch_depth, check_tree(stretch_depth));
+
+  long long nodes = (1LL << (max_depth + 1)) - 1;
+  long long *long_lived_left = calloc(nodes, sizeof(long long));
+  long long *long_lived_right = calloc(nodes, sizeof(long long));
+
+  bottom_up_tree(long_lived_left, long_lived_right, 0, max_depth);
+
+  long long depth = min_depth;
+
+  while (depth <= max_depth) {
+    long long iterations = 1LL << (max_depth - depth + min_depth), check = 0, i = 0;
+
+    while (i < iterations) {
+      check += check_tree(depth);
+
+      i++;
+    }
+
+    printf("%lli trees of depth %lli check: %lli\n", iterations, depth, check);
+
+    depth += 2;
+  }
+
+  printf(
+    "long lived tree of depth %lli check: %lli\n",
+    max_depth,
+    item_check(long_lived_left, long_lived_right, 0)
+  );
+
+  free(long_lived_left);
+  free(long_lived_right);
+
+  return 0;
+}
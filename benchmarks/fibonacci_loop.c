@@ -0,0 +1,36 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+long long fibonacci_loop(long long x) {
+  long long a = 1, b = 0, temp = a;
+
+  while (x > 0) {
+    temp = a;
+
+    a += b;
+
+    b = temp;
+
+    x--;
+  }
+
+  return b;
+}
+
+int main(int argc, char **argv) {
+  long long count = 20000000;
+
+  if (argc > 1) count = atoll(argv[1]);
+
+  long long result = 0, i = 0;
+
+  while (i < count) {
+    result = result ^ fibonacci_loop(i % 90);
+
+    i++;
+  }
+
+  printf("%lli\n", result);
+
+  return 0;
+}
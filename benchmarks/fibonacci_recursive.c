@@ -0,0 +1,18 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+long long fibonacci_recursive(long long x) {
+  if (x <= 2) return 1;
+
+  return fibonacci_recursive(x - 1) + fibonacci_recursive(x - 2);
+}
+
+int main(int argc, char **argv) {
+  long long n = 40;
+
+  if (argc > 1) n = atoll(argv[1]);
+
+  printf("%lli\n", fibonacci_recursive(n));
+
+  return 0;
+}
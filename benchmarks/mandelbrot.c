@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+long long mandelbrot(long long size, long long iterations) {
+  long long count = 0, y = 0;
+
+  while (y < size) {
+    double ci = 2.0 * (double) y / (double) size - 1.0;
+    long long x = 0;
+
+    while (x < size) {
+      double cr = 2.0 * (double) x / (double) size - 1.5;
+      double zr = 0.0, zi = 0.0;
+      long long i = 0;
+
+      while (i < iterations) {
+        double zr2 = zr * zr, zi2 = zi * zi;
+
+        if (zr2 + zi2 > 4.0) break;
+
+        zi = 2.0 * zr * zi + ci;
+
+        zr = zr2 - zi2 + cr;
+
+        i++;
+      }
+
+      if (i == iterations) count++;
+
+      x++;
+    }
+
+    y++;
+  }
+
+  return count;
+}
+
+int main(int argc, char **argv) {
+  long long size = 2000, iterations = 50;
+
+  if (argc > 1) size = atoll(argv[1]);
+
+  if (argc > 2) iterations = atoll(argv[2]);
+
+  printf("%lli\n", mandelbrot(size, iterations));
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+void matrix_fill(double *m, long long n, double seed) {
+  double scale = seed / (double) n / (double) n;
+  long long i = 0;
+
+  while (i < n) {
+    long long j = 0;
+
+    while (j < n) {
+      m[i * n + j] = scale * (double) (i - j) * (double) (i + j);
+
+      j++;
+    }
+
+    i++;
+  }
+}
+
+void matrix_multiply(const double *a, const double *b, double *c, long long n) {
+  long long i = 0;
+
+  while (i < n) {
+    long long k = 0;
+
+    while (k < n) {
+      double aik = a[i * n + k];
+      long long j = 0;
+
+      while (j < n) {
+        c[i * n + j] = c[i * n + j] + aik * b[k * n + j];
+
+        j++;
+      }
+
+      k++;
+    }
+
+    i++;
+  }
+}
+
+int main(int argc, char **argv) {
+  long long n = 500;
+
+  if (argc > 1) n = atoll(argv[1]);
+
+  double *a = calloc(n * n, sizeof(double));
+  double *b = calloc(n * n, sizeof(double));
+  double *c = calloc(n * n, sizeof(double));
+
+  matrix_fill(a, n, 1.0);
+
+  matrix_fill(b, n, 2.0);
+
+  matrix_multiply(a, b, c, n);
+
+  printf("%.6f\n", c[(n / 2) * n + n / 2]);
+
+  free(a);
+  free(b);
+  free(c);
+
+  return 0;
+}
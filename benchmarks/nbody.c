@@ -0,0 +1,321 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char **argv) {
+  double x0 = 0.0;
+  double y0 = 0.0;
+  double z0 = 0.0;
+  double vx0 = 0.0 * 365.24;
+  double vy0 = 0.0 * 365.24;
+  double vz0 = 0.0 * 365.24;
+  double m0 = 1.0 * 4.0 * 3.141592653589793 * 3.141592653589793;
+  double x1 = 4.84143144246472090;
+  double y1 = -1.16032004402742839;
+  double z1 = -0.103622044471123109;
+  double vx1 = 0.00166007664274403694 * 365.24;
+  double vy1 = 0.00769901118419740425 * 365.24;
+  double vz1 = -0.0000690460016972063023 * 365.24;
+  double m1 = 0.000954791938424326609 * 4.0 * 3.141592653589793 * 3.141592653589793;
+  double x2 = 8.34336671824457987;
+  double y2 = 4.12479856412430479;
+  double z2 = -0.403523417114321381;
+  double vx2 = -0.00276742510726862411 * 365.24;
+  double vy2 = 0.00499852801234917238 * 365.24;
+  double vz2 = 0.0000230417297573763929 * 365.24;
+  double m2 = 0.000285885980666130812 * 4.0 * 3.141592653589793 * 3.141592653589793;
+  double x3 = 12.8943695621391310;
+  double y3 = -15.1111514016986312;
+  double z3 = -0.223307578892655734;
+  double vx3 = 0.00296460137564761618 * 365.24;
+  double vy3 = 0.00237847173959480950 * 365.24;
+  double vz3 = -0.0000296589568540237556 * 365.24;
+  double m3 = 0.0000436624404335156298 * 4.0 * 3.141592653589793 * 3.141592653589793;
+  double x4 = 15.3796971148509165;
+  double y4 = -25.9193146099879641;
+  double z4 = 0.179258772950371181;
+  double vx4 = 0.00268067772490389322 * 365.24;
+  double vy4 = 0.00162824170038242295 * 365.24;
+  double vz4 = -0.0000951592254519715870 * 365.24;
+  double m4 = 0.0000515138902046611451 * 4.0 * 3.141592653589793 * 3.141592653589793;
+
+  double dt = 0.01, e = 0.0, px = 0.0, py = 0.0, pz = 0.0;
+  double dx = 0.0, dy = 0.0, dz = 0.0, d2 = 0.0, mag = 0.0;
+  long long step = 0, steps = 5000000;
+
+  if (argc > 1) steps = atoll(argv[1]);
+
+  px = 0.0;
+  py = 0.0;
+  pz = 0.0;
+
+  px = px + vx0 * m0;
+  py = py + vy0 * m0;
+  pz = pz + vz0 * m0;
+  px = px + vx1 * m1;
+  py = py + vy1 * m1;
+  pz = pz + vz1 * m1;
+  px = px + vx2 * m2;
+  py = py + vy2 * m2;
+  pz = pz + vz2 * m2;
+  px = px + vx3 * m3;
+  py = py + vy3 * m3;
+  pz = pz + vz3 * m3;
+  px = px + vx4 * m4;
+  py = py + vy4 * m4;
+  pz = pz + vz4 * m4;
+
+  vx0 = 0.0 - px / (4.0 * 3.141592653589793 * 3.141592653589793);
+  vy0 = 0.0 - py / (4.0 * 3.141592653589793 * 3.141592653589793);
+  vz0 = 0.0 - pz / (4.0 * 3.141592653589793 * 3.141592653589793);
+
+  e = 0.0;
+
+  e = e + 0.5 * m0 * (vx0 * vx0 + vy0 * vy0 + vz0 * vz0);
+  dx = x0 - x1;
+  dy = y0 - y1;
+  dz = z0 - z1;
+  e = e - m0 * m1 / sqrt(dx * dx + dy * dy + dz * dz);
+  dx = x0 - x2;
+  dy = y0 - y2;
+  dz = z0 - z2;
+  e = e - m0 * m2 / sqrt(dx * dx + dy * dy + dz * dz);
+  dx = x0 - x3;
+  dy = y0 - y3;
+  dz = z0 - z3;
+  e = e - m0 * m3 / sqrt(dx * dx + dy * dy + dz * dz);
+  dx = x0 - x4;
+  dy = y0 - y4;
+  dz = z0 - z4;
+  e = e - m0 * m4 / sqrt(dx * dx + dy * dy + dz * dz);
+
+  e = e + 0.5 * m1 * (vx1 * vx1 + vy1 * vy1 + vz1 * vz1);
+  dx = x1 - x2;
+  dy = y1 - y2;
+  dz = z1 - z2;
+  e = e - m1 * m2 / sqrt(dx * dx + dy * dy + dz * dz);
+  dx = x1 - x3;
+  dy = y1 - y3;
+  dz = z1 - z3;
+  e = e - m1 * m3 / sqrt(dx * dx + dy * dy + dz * dz);
+  dx = x1 - x4;
+  dy = y1 - y4;
+  dz = z1 - z4;
+  e = e - m1 * m4 / sqrt(dx * dx + dy * dy + dz * dz);
+
+  e = e + 0.5 * m2 * (vx2 * vx2 + vy2 * vy2 + vz2 * vz2);
+  dx = x2 - x3;
+  dy = y2 - y3;
+  dz = z2 - z3;
+  e = e - m2 * m3 / sqrt(dx * dx + dy * dy + dz * dz);
+  dx = x2 - x4;
+  dy = y2 - y4;
+  dz = z2 - z4;
+  e = e - m2 * m4 / sqrt(dx * dx + dy * dy + dz * dz);
+
+  e = e + 0.5 * m3 * (vx3 * vx3 + vy3 * vy3 + vz3 * vz3);
+  dx = x3 - x4;
+  dy = y3 - y4;
+  dz = z3 - z4;
+  e = e - m3 * m4 / sqrt(dx * dx + dy * dy + dz * dz);
+
+  e = e + 0.5 * m4 * (vx4 * vx4 + vy4 * vy4 + vz4 * vz4);
+
+  printf("%.9f\n", e);
+
+  while (step < steps) {
+    dx = x0 - x1;
+    dy = y0 - y1;
+    dz = z0 - z1;
+    d2 = dx * dx + dy * dy + dz * dz;
+    mag = dt / (d2 * sqrt(d2));
+    vx0 = vx0 - dx * m1 * mag;
+    vy0 = vy0 - dy * m1 * mag;
+    vz0 = vz0 - dz * m1 * mag;
+    vx1 = vx1 + dx * m0 * mag;
+    vy1 = vy1 + dy * m0 * mag;
+    vz1 = vz1 + dz * m0 * mag;
+
+    dx = x0 - x2;
+    dy = y0 - y2;
+    dz = z0 - z2;
+    d2 = dx * dx + dy * dy + dz * dz;
+    mag = dt / (d2 * sqrt(d2));
+    vx0 = vx0 - dx * m2 * mag;
+    vy0 = vy0 - dy * m2 * mag;
+    vz0 = vz0 - dz * m2 * mag;
+    vx2 = vx2 + dx * m0 * mag;
+    vy2 = vy2 + dy * m0 * mag;
+    vz2 = vz2 + dz * m0 * mag;
+
+    dx = x0 - x3;
+    dy = y0 - y3;
+    dz = z0 - z3;
+    d2 = dx * dx + dy * dy + dz * dz;
+    mag = dt / (d2 * sqrt(d2));
+    vx0 = vx0 - dx * m3 * mag;
+    vy0 = vy0 - dy * m3 * mag;
+    vz0 = vz0 - dz * m3 * mag;
+    vx3 = vx3 + dx * m0 * mag;
+    vy3 = vy3 + dy * m0 * mag;
+    vz3 = vz3 + dz * m0 * mag;
+
+    dx = x0 - x4;
+    dy = y0 - y4;
+    dz = z0 - z4;
+    d2 = dx * dx + dy * dy + dz * dz;
+    mag = dt / (d2 * sqrt(d2));
+    vx0 = vx0 - dx * m4 * mag;
+    vy0 = vy0 - dy * m4 * mag;
+    vz0 = vz0 - dz * m4 * mag;
+    vx4 = vx4 + dx * m0 * mag;
+    vy4 = vy4 + dy * m0 * mag;
+    vz4 = vz4 + dz * m0 * mag;
+
+    dx = x1 - x2;
+    dy = y1 - y2;
+    dz = z1 - z2;
+    d2 = dx * dx + dy * dy + dz * dz;
+    mag = dt / (d2 * sqrt(d2));
+    vx1 = vx1 - dx * m2 * mag;
+    vy1 = vy1 - dy * m2 * mag;
+    vz1 = vz1 - dz * m2 * mag;
+    vx2 = vx2 + dx * m1 * mag;
+    vy2 = vy2 + dy * m1 * mag;
+    vz2 = vz2 + dz * m1 * mag;
+
+    dx = x1 - x3;
+    dy = y1 - y3;
+    dz = z1 - z3;
+    d2 = dx * dx + dy * dy + dz * dz;
+    mag = dt / (d2 * sqrt(d2));
+    vx1 = vx1 - dx * m3 * mag;
+    vy1 = vy1 - dy * m3 * mag;
+    vz1 = vz1 - dz * m3 * mag;
+    vx3 = vx3 + dx * m1 * mag;
+    vy3 = vy3 + dy * m1 * mag;
+    vz3 = vz3 + dz * m1 * mag;
+
+    dx = x1 - x4;
+    dy = y1 - y4;
+    dz = z1 - z4;
+    d2 = dx * dx + dy * dy + dz * dz;
+    mag = dt / (d2 * sqrt(d2));
+    vx1 = vx1 - dx * m4 * mag;
+    vy1 = vy1 - dy * m4 * mag;
+    vz1 = vz1 - dz * m4 * mag;
+    vx4 = vx4 + dx * m1 * mag;
+    vy4 = vy4 + dy * m1 * mag;
+    vz4 = vz4 + dz * m1 * mag;
+
+    dx = x2 - x3;
+    dy = y2 - y3;
+    dz = z2 - z3;
+    d2 = dx * dx + dy * dy + dz * dz;
+    mag = dt / (d2 * sqrt(d2));
+    vx2 = vx2 - dx * m3 * mag;
+    vy2 = vy2 - dy * m3 * mag;
+    vz2 = vz2 - dz * m3 * mag;
+    vx3 = vx3 + dx * m2 * mag;
+    vy3 = vy3 + dy * m2 * mag;
+    vz3 = vz3 + dz * m2 * mag;
+
+    dx = x2 - x4;
+    dy = y2 - y4;
+    dz = z2 - z4;
+    d2 = dx * dx + dy * dy + dz * dz;
+    mag = dt / (d2 * sqrt(d2));
+    vx2 = vx2 - dx * m4 * mag;
+    vy2 = vy2 - dy * m4 * mag;
+    vz2 = vz2 - dz * m4 * mag;
+    vx4 = vx4 + dx * m2 * mag;
+    vy4 = vy4 + dy * m2 * mag;
+    vz4 = vz4 + dz * m2 * mag;
+
+    dx = x3 - x4;
+    dy = y3 - y4;
+    dz = z3 - z4;
+    d2 = dx * dx + dy * dy + dz * dz;
+    mag = dt / (d2 * sqrt(d2));
+    vx3 = vx3 - dx * m4 * mag;
+    vy3 = vy3 - dy * m4 * mag;
+    vz3 = vz3 - dz * m4 * mag;
+    vx4 = vx4 + dx * m3 * mag;
+    vy4 = vy4 + dy * m3 * mag;
+    vz4 = vz4 + dz * m3 * mag;
+
+    x0 = x0 + dt * vx0;
+    y0 = y0 + dt * vy0;
+    z0 = z0 + dt * vz0;
+    x1 = x1 + dt * vx1;
+    y1 = y1 + dt * vy1;
+    z1 = z1 + dt * vz1;
+    x2 = x2 + dt * vx2;
+    y2 = y2 + dt * vy2;
+    z2 = z2 + dt * vz2;
+    x3 = x3 + dt * vx3;
+    y3 = y3 + dt * vy3;
+    z3 = z3 + dt * vz3;
+    x4 = x4 + dt * vx4;
+    y4 = y4 + dt * vy4;
+    z4 = z4 + dt * vz4;
+
+    step++;
+  }
+
+  e = 0.0;
+
+  e = e + 0.5 * m0 * (vx0 * vx0 + vy0 * vy0 + vz0 * vz0);
+  dx = x0 - x1;
+  dy = y0 - y1;
+  dz = z0 - z1;
+  e = e - m0 * m1 / sqrt(dx * dx + dy * dy + dz * dz);
+  dx = x0 - x2;
+  dy = y0 - y2;
+  dz = z0 - z2;
+  e = e - m0 * m2 / sqrt(dx * dx + dy * dy + dz * dz);
+  dx = x0 - x3;
+  dy = y0 - y3;
+  dz = z0 - z3;
+  e = e - m0 * m3 / sqrt(dx * dx + dy * dy + dz * dz);
+  dx = x0 - x4;
+  dy = y0 - y4;
+  dz = z0 - z4;
+  e = e - m0 * m4 / sqrt(dx * dx + dy * dy + dz * dz);
+
+  e = e + 0.5 * m1 * (vx1 * vx1 + vy1 * vy1 + vz1 * vz1);
+  dx = x1 - x2;
+  dy = y1 - y2;
+  dz = z1 - z2;
+  e = e - m1 * m2 / sqrt(dx * dx + dy * dy + dz * dz);
+  dx = x1 - x3;
+  dy = y1 - y3;
+  dz = z1 - z3;
+  e = e - m1 * m3 / sqrt(dx * dx + dy * dy + dz * dz);
+  dx = x1 - x4;
+  dy = y1 - y4;
+  dz = z1 - z4;
+  e = e - m1 * m4 / sqrt(dx * dx + dy * dy + dz * dz);
+
+  e = e + 0.5 * m2 * (vx2 * vx2 + vy2 * vy2 + vz2 * vz2);
+  dx = x2 - x3;
+  dy = y2 - y3;
+  dz = z2 - z3;
+  e = e - m2 * m3 / sqrt(dx * dx + dy * dy + dz * dz);
+  dx = x2 - x4;
+  dy = y2 - y4;
+  dz = z2 - z4;
+  e = e - m2 * m4 / sqrt(dx * dx + dy * dy + dz * dz);
+
+  e = e + 0.5 * m3 * (vx3 * vx3 + vy3 * vy3 + vz3 * vz3);
+  dx = x3 - x4;
+  dy = y3 - y4;
+  dz = z3 - z4;
+  e = e - m3 * m4 / sqrt(dx * dx + dy * dy + dz * dz);
+
+  e = e + 0.5 * m4 * (vx4 * vx4 + vy4 * vy4 + vz4 * vz4);
+
+  printf("%.9f\n", e);
+
+  return 0;
+}
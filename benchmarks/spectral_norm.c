@@ -0,0 +1,102 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+double eval_a(long long i, long long j) {
+  return 1.0 / (double) ((i + j) * (i + j + 1) / 2 + i + 1);
+}
+
+void multiply_av(long long n, const double *v, double *av) {
+  long long i = 0;
+
+  while (i < n) {
+    double sum = 0.0;
+    long long j = 0;
+
+    while (j < n) {
+      sum += eval_a(i, j) * v[j];
+
+      j++;
+    }
+
+    av[i] = sum;
+
+    i++;
+  }
+}
+
+void multiply_atv(long long n, const double *v, double *atv) {
+  long long i = 0;
+
+  while (i < n) {
+    double sum = 0.0;
+    long long j = 0;
+
+    while (j < n) {
+      sum += eval_a(j, i) * v[j];
+
+      j++;
+    }
+
+    atv[i] = sum;
+
+    i++;
+  }
+}
+
+void multiply_atav(long long n, const double *v, double *tmp, double *atav) {
+  multiply_av(n, v, tmp);
+
+  multiply_atv(n, tmp, atav);
+}
+
+double spectral_norm(long long n) {
+  double *u = calloc(n, sizeof(double));
+  double *v = calloc(n, sizeof(double));
+  double *tmp = calloc(n, sizeof(double));
+  long long i = 0;
+
+  while (i < n) {
+    u[i] = 1.0;
+
+    i++;
+  }
+
+  i = 0;
+
+  while (i < 10) {
+    multiply_atav(n, u, tmp, v);
+
+    multiply_atav(n, v, tmp, u);
+
+    i++;
+  }
+
+  double vbv = 0.0, vv = 0.0;
+
+  i = 0;
+
+  while (i < n) {
+    vbv += u[i] * v[i];
+
+    vv += v[i] * v[i];
+
+    i++;
+  }
+
+  free(u);
+  free(v);
+  free(tmp);
+
+  return sqrt(vbv / vv);
+}
+
+int main(int argc, char **argv) {
+  long long n = 1000;
+
+  if (argc > 1) n = atoll(argv[1]);
+
+  printf("%.9f\n", spectral_norm(n));
+
+  return 0;
+}
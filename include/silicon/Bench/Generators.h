@@ -0,0 +1,58 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#ifndef SILICON_GENERATORS_H
+#define SILICON_GENERATORS_H
+
+
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace silicon::bench {
+
+    struct generator_t {
+        std::string name;
+
+        // Default size of the generated program, multiplied by the benchmark scale
+        unsigned size = 0;
+
+        std::function<std::string(unsigned)> generate;
+    };
+
+    // Thousands of small functions, each calling the previous one
+    std::string generate_functions(unsigned count);
+
+    // A single function with blocks nested <depth> levels deep
+    std::string generate_nesting(unsigned depth);
+
+    // A chain of interfaces extending each other and heavy access to the fields of the deepest one
+    std::string generate_interfaces(unsigned count);
+
+    // A single expression of <length> terms
+    std::string generate_expressions(unsigned length);
+
+    // <count> string literals, each used twice
+    std::string generate_strings(unsigned count);
+
+    std::vector<generator_t> generators();
+
+}
+
+
+#endif //SILICON_GENERATORS_H
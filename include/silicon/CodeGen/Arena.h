@@ -0,0 +1,78 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#ifndef SILICON_ARENA_H
+#define SILICON_ARENA_H
+
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/StringSaver.h"
+
+
+namespace silicon::codegen {
+
+    // Bump-pointer arena owned by a compilation, everything allocated from it is released at once
+    // when the arena is destroyed. Nodes own std containers and strings, so the destructors of objects that
+    // have one are registered and run first, in reverse order of construction.
+    class Arena {
+    protected:
+        llvm::BumpPtrAllocator allocator;
+
+        llvm::UniqueStringSaver strings{allocator};
+
+        std::vector<std::pair<void *, void (*)(void *)>> destructors;
+
+    public:
+        Arena() = default;
+
+        Arena(const Arena &) = delete;
+
+        Arena &operator=(const Arena &) = delete;
+
+        ~Arena() {
+            for (auto it = destructors.rbegin(); it != destructors.rend(); ++it) it->second(it->first);
+        }
+
+        template<typename T, typename... Args>
+        T *make(Args &&... args) {
+            T *object = new(allocator.Allocate<T>()) T(std::forward<Args>(args)...);
+
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                destructors.emplace_back(object, [](void *pointer) { static_cast<T *>(pointer)->~T(); });
+            }
+
+            return object;
+        }
+
+        // Equal strings are stored once, so interned strings can be compared and hashed by their data pointer.
+        llvm::StringRef intern(llvm::StringRef string) {
+            return strings.save(string);
+        }
+
+        size_t size() const {
+            return allocator.getTotalMemory();
+        }
+    };
+
+}
+
+
+#endif //SILICON_ARENA_H
@@ -33,6 +33,8 @@ namespace silicon::codegen {
 
         llvm::Value *left = nullptr;
         llvm::Value *right = nullptr;
+
+        bool is_unsigned = false;
     };
 
     class CGBinaryOperation : public CGNode, public parser::AST::BinaryOperation {
@@ -44,9 +46,14 @@ namespace silicon::codegen {
         std::string stringify_operator();
 
     protected:
+        CGNode *cg_left;
+        CGNode *cg_right;
+
         void unsupported_op(Context *ctx, llvm::Type *t1, llvm::Type *t2) noexcept __attribute__ ((__noreturn__));
 
-        value_pair_t *parse_pair(Context *ctx);
+        value_pair_t parse_pair(Context *ctx);
+
+        static bool is_cheap(CGNode *node, unsigned &budget);
 
         llvm::Value *assign(Context *ctx);
 
@@ -56,6 +63,10 @@ namespace silicon::codegen {
 
         llvm::Value *remainder(Context *ctx);
 
+        llvm::Value *power(Context *ctx);
+
+        llvm::Value *power_chain(Context *ctx, llvm::Value *base, uint64_t exponent);
+
         llvm::Value *add(Context *ctx);
 
         llvm::Value *sub(Context *ctx);
@@ -84,6 +95,12 @@ namespace silicon::codegen {
 
         llvm::Value *gt(Context *ctx);
 
+        llvm::Value *short_circuit(Context *ctx, bool is_or);
+
+        llvm::Value *logical_and(Context *ctx);
+
+        llvm::Value *logical_or(Context *ctx);
+
         llvm::Value *cast(Context *ctx);
     };
 
@@ -19,9 +19,7 @@
 #define SILICON_CGCODEBLOCK_H
 
 
-#include <map>
-#include <string>
-#include "llvm/IR/Instructions.h"
+#include <vector>
 #include "llvm/IR/Value.h"
 #include "silicon/CodeGen/CGNode.h"
 #include "silicon/CodeGen/Context.h"
@@ -32,22 +30,12 @@ namespace silicon::codegen {
 
     class CGCodeBlock : public CGNode, public parser::AST::CodeBlock {
     protected:
-        CGCodeBlock *parent = nullptr;
-
-        std::map<std::string, llvm::AllocaInst *> variables;
+        std::vector<CGNode *> cg_statements;
 
     public:
         explicit CGCodeBlock(parser::AST::CodeBlock *node);
 
         llvm::Value *codegen(Context *ctx) override;
-
-        bool allocated(const std::string &name);
-
-        llvm::AllocaInst *get_alloca(const std::string &name);
-
-        llvm::Value *alloc(Context *ctx, const std::string &name, llvm::Type *type);
-
-        friend class Context;
     };
 
 }
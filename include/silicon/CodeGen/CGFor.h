@@ -29,6 +29,11 @@ namespace silicon::codegen {
 
     class CGFor : public CGNode, public parser::AST::For {
     protected:
+        CGNode *cg_definition;
+        CGNode *cg_condition;
+        CGNode *cg_stepper;
+        CGNode *cg_body;
+
         llvm::Value *definitionCodegen(Context *ctx);
 
         llvm::Value *conditionCodegen(Context *ctx);
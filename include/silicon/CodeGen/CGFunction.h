@@ -27,7 +27,13 @@
 
 namespace silicon::codegen {
 
+    class CGPrototype;
+
     class CGFunction : public CGNode, public parser::AST::Function {
+    protected:
+        CGPrototype *cg_prototype;
+        CGNode *cg_body;
+
     public:
         explicit CGFunction(parser::AST::Function *node);
 
@@ -19,6 +19,8 @@
 #define SILICON_CGFUNCTIONCALL_H
 
 
+#include <vector>
+#include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Value.h"
 #include "silicon/CodeGen/CGNode.h"
 #include "silicon/CodeGen/Context.h"
@@ -28,10 +30,49 @@
 namespace silicon::codegen {
 
     class CGFunctionCall : public CGNode, public parser::AST::FunctionCall {
+    protected:
+        std::vector<CGNode *> cg_args;
+
+        llvm::Value *builtin(Context *ctx);
+
+        static bool points_to_frame(Context *ctx, llvm::Value *value);
+
+        void expect_args(size_t count);
+
+        llvm::Value *element_pointer(Context *ctx, unsigned count);
+
+        llvm::VectorType *expected_vector(Context *ctx);
+
+        llvm::Value *vector_arg(Context *ctx, unsigned i);
+
+        llvm::Value *splat(Context *ctx);
+
+        llvm::Value *shuffle(Context *ctx);
+
+        llvm::Value *reduce(Context *ctx);
+
+        llvm::Value *select(Context *ctx);
+
+        llvm::Value *alloc(Context *ctx);
+
+        llvm::Value *free(Context *ctx);
+
+        llvm::Value *vector_load(Context *ctx);
+
+        llvm::Value *vector_store(Context *ctx);
+
     public:
+        // Set by the return statement whose value is this call
+        bool tail_position = false;
+
+        // Set by the variable definition this call initializes, only those are evaluated at compile time
+        bool initializer = false;
+
         explicit CGFunctionCall(parser::AST::FunctionCall *node);
 
         llvm::Value *codegen(Context *ctx) override;
+
+        llvm::Value *get_pointer(Context *ctx);
     };
 
 }
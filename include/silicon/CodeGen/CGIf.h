@@ -29,6 +29,10 @@ namespace silicon::codegen {
 
     class CGIf : public CGNode, public parser::AST::If {
     protected:
+        CGNode *cg_condition;
+        CGNode *cg_then;
+        CGNode *cg_else;
+
         bool has_then();
 
         bool has_else();
@@ -20,7 +20,9 @@
 
 
 #include <string>
+#include <unordered_map>
 #include <vector>
+#include "llvm/ADT/StringRef.h"
 #include "llvm/IR/Value.h"
 #include "silicon/CodeGen/CGNode.h"
 #include "silicon/CodeGen/CGType.h"
@@ -31,6 +33,24 @@
 namespace silicon::codegen {
 
     class CGInterface : public CGNode, public parser::AST::Interface {
+    protected:
+        // Names interned once in the arena, the interface's and those of its bases
+        llvm::StringRef symbol;
+
+        std::vector<llvm::StringRef> base_symbols;
+
+        // Own properties, resolved when the node is built
+        std::vector<std::pair<std::string, CGType *>> cg_properties;
+
+        // Flattened layout (base interface properties first) and property name to field index, built once
+        bool laid_out = false;
+
+        std::vector<std::pair<std::string, CGType *>> layout;
+
+        std::unordered_map<std::string, uint64_t> indices;
+
+        void build_layout(Context *ctx);
+
     public:
         explicit CGInterface(parser::AST::Interface *node);
 
@@ -38,7 +58,7 @@ namespace silicon::codegen {
 
         uint64_t property_index(Context *ctx, const std::string &property);
 
-        std::vector<std::pair<std::string, CGType *>> get_properties(Context *ctx);
+        const std::vector<std::pair<std::string, CGType *>> &get_properties(Context *ctx);
     };
 
 }
@@ -29,6 +29,8 @@ namespace silicon::codegen {
 
     class CGLoop : public CGNode, public parser::AST::Loop {
     protected:
+        CGNode *cg_body;
+
         llvm::Value *body_codegen(Context *ctx);
 
     public:
@@ -28,7 +28,15 @@ namespace silicon::codegen {
 
     class CGNode : virtual public parser::AST::Node {
     public:
+        // The arena of the compilation currently parsing on this thread, nodes are allocated
+        // and intern their names there as they are built.
+        static thread_local Arena *arena;
+
         virtual llvm::Value *codegen(Context *ctx) = 0;
+
+        // The parser walks children before their parent, so every child of a walked node is a CG node.
+        // Nodes resolve their children once when built, codegen then follows typed pointers.
+        static CGNode *resolve(parser::AST::Node *node);
     };
 
 }
@@ -29,6 +29,9 @@ namespace silicon::codegen {
 
     class CGNumberLiteral : public CGNode, public parser::AST::NumberLiteral {
     public:
+        // Set by the negation whose operand is this literal, signed types reach one further below zero
+        bool negated = false;
+
         explicit CGNumberLiteral(parser::AST::NumberLiteral *node);
 
         llvm::Value *codegen(Context *ctx) override;
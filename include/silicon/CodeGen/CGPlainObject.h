@@ -19,6 +19,8 @@
 #define SILICON_CGPLAINOBJECT_H
 
 
+#include <string>
+#include <vector>
 #include "llvm/IR/Value.h"
 #include "silicon/CodeGen/CGNode.h"
 #include "silicon/CodeGen/Context.h"
@@ -28,6 +30,9 @@
 namespace silicon::codegen {
 
     class CGPlainObject : public CGNode, public parser::AST::PlainObject {
+    protected:
+        std::vector<std::pair<std::string, CGNode *>> cg_properties;
+
     public:
         explicit CGPlainObject(parser::AST::PlainObject *node);
 
@@ -19,6 +19,7 @@
 #define SILICON_CGPROTOTYPE_H
 
 
+#include <vector>
 #include "llvm/IR/Value.h"
 #include "silicon/CodeGen/CGNode.h"
 #include "silicon/CodeGen/Context.h"
@@ -27,13 +28,22 @@
 
 namespace silicon::codegen {
 
+    class CGType;
+
     class CGPrototype : public CGNode, public parser::AST::Prototype {
+    protected:
+        std::vector<CGType *> cg_argument_types;
+        CGType *cg_return_type;
+
     public:
         explicit CGPrototype(parser::AST::Prototype *node);
 
         llvm::Value *codegen(Context *ctx) override;
 
         llvm::Type *get_return_type(Context *ctx);
+
+        // main may take its command line as a string slice, the C runtime passes it as argc and argv
+        bool takes_command_line(Context *ctx);
     };
 
 }
@@ -28,6 +28,9 @@
 namespace silicon::codegen {
 
     class CGReturn : public CGNode, public parser::AST::Return {
+    protected:
+        CGNode *cg_value;
+
     public:
         explicit CGReturn(parser::AST::Return *node);
 
@@ -19,6 +19,7 @@
 #define SILICON_CGSTRING_H
 
 
+#include "llvm/ADT/StringRef.h"
 #include "llvm/IR/Value.h"
 #include "silicon/CodeGen/CGNode.h"
 #include "silicon/CodeGen/Context.h"
@@ -29,6 +30,9 @@ namespace silicon::codegen {
 
     class CGString : public CGNode, public parser::AST::String {
     public:
+        // Value interned once in the arena, equal literals share one global
+        llvm::StringRef symbol;
+
         explicit CGString(parser::AST::String *node);
 
         llvm::Value *codegen(Context *ctx) override;
@@ -19,6 +19,7 @@
 #define SILICON_CGTYPE_H
 
 
+#include "llvm/ADT/StringRef.h"
 #include "llvm/IR/Value.h"
 #include "llvm/IR/Type.h"
 #include "silicon/CodeGen/CGNode.h"
@@ -30,11 +31,18 @@ namespace silicon::codegen {
 
     class CGType : public CGNode, public parser::AST::Type {
     public:
+        // Names interned once in the arena, the type itself and the element of arrays and slices
+        llvm::StringRef symbol;
+
+        llvm::StringRef element_symbol;
+
         explicit CGType(parser::AST::Type *node);
 
         llvm::Value *codegen(Context *ctx) override;
 
         llvm::Type *typegen(Context *ctx);
+
+        bool is_unsigned(Context *ctx);
     };
 
 }
@@ -36,6 +36,8 @@ namespace silicon::codegen {
         std::string stringify_operator();
 
     protected:
+        CGNode *cg_node;
+
         void unsupported_op(Context *ctx, llvm::Type *type) noexcept __attribute__ ((__noreturn__));
 
         llvm::Value *increment(Context *ctx);
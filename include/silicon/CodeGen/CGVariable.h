@@ -29,9 +29,16 @@ namespace silicon::codegen {
 
     class CGVariable : public CGNode, public parser::AST::Variable {
     protected:
+        CGNode *cg_context;
+
         uint64_t element_index(Context *ctx);
 
+        llvm::Value *array_length(Context *ctx);
+
     public:
+        // Name interned once in the arena, looked up without hashing the string again
+        llvm::StringRef symbol;
+
         explicit CGVariable(parser::AST::Variable *node);
 
         llvm::Value *codegen(Context *ctx) override;
@@ -27,7 +27,12 @@
 
 namespace silicon::codegen {
 
+    class CGType;
+
     class CGVariableDefinition : public CGNode, public parser::AST::VariableDefinition {
+    protected:
+        CGType *cg_type;
+
     public:
         explicit CGVariableDefinition(parser::AST::VariableDefinition *node);
 
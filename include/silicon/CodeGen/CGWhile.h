@@ -29,6 +29,9 @@ namespace silicon::codegen {
 
     class CGWhile : public CGNode, public parser::AST::While {
     protected:
+        CGNode *cg_condition;
+        CGNode *cg_body;
+
         bool has_body();
 
         llvm::Value *condition_codegen(Context *ctx);
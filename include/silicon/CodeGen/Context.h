@@ -21,11 +21,24 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/IR/ValueMap.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+#include "silicon/CodeGen/Arena.h"
+#include "silicon/CodeGen/Evaluator.h"
+#include "silicon/CodeGen/Options.h"
+#include "silicon/CodeGen/SymbolTable.h"
+#include "silicon/CodeGen/TimeTrace.h"
 
 
 namespace silicon::codegen {
@@ -35,55 +48,121 @@ namespace silicon::codegen {
 
         llvm::BasicBlock *break_point = nullptr;
         llvm::BasicBlock *continue_point = nullptr;
+
+        // Scope depth the loop was entered at, break and continue leave the scopes below it
+        size_t depth = 0;
     };
 
     class CGNode;
 
-    class CGCodeBlock;
-
     class CGInterface;
 
     class Context {
     protected:
-        CGCodeBlock *code_block = nullptr;
+        std::unique_ptr<llvm::LLVMContext> llvm_ctx_ptr;
+
+        void populate_pass_manager_builder(llvm::PassManagerBuilder &builder);
+
+        void infer_attributes();
+
+        void bounds_branch(llvm::Value *in_bounds);
 
     public:
-        llvm::LLVMContext llvm_ctx;
+        Arena arena;
+
+        llvm::LLVMContext &llvm_ctx;
         llvm::IRBuilder<> llvm_ir_builder;
         std::unique_ptr<llvm::Module> llvm_module;
         std::unique_ptr<llvm::legacy::FunctionPassManager> llvm_fpm;
 
-        std::map<std::string, llvm::Type *> types;
+        optimization_level_t optimization_level;
+
+        TimeTrace *time_trace = nullptr;
+
+        // Names are interned in the arena when their node is built, registries are keyed by their data pointer
+        llvm::DenseMap<const char *, llvm::Type *> types;
+
+        llvm::DenseMap<const char *, CGInterface *> interfaces;
+
+        llvm::DenseMap<const char *, llvm::GlobalVariable *> strings;
+
+        // Reverse registries filled by def_type/def_interface
+        std::unordered_map<llvm::Type *, llvm::StringRef> type_names;
+
+        std::unordered_map<llvm::Type *, CGInterface *> type_interfaces;
 
-        std::map<std::string, CGInterface *> interfaces;
+        // Element types of the slices created by slice_type
+        std::unordered_map<llvm::Type *, llvm::Type *> slice_elements;
+
+        // LLVM integers are signless, unsigned ones are tracked by interned name and by value.
+        // Marked values are unsigned integers, pointers to them, or functions returning them.
+        llvm::DenseSet<const char *> unsigned_types;
+
+        // Values are held through value handles: the optimizer deletes marked values, and a mark
+        // left on a freed address would carry over to whatever value is allocated there next.
+        // Marks don't follow replacements, which may be shared constants.
+        struct unsigned_config_t : llvm::ValueMapConfig<const llvm::Value *> {
+            enum { FollowRAUW = false };
+        };
+
+        llvm::ValueMap<const llvm::Value *, bool, unsigned_config_t> unsigned_values;
 
         llvm::Type *expected_type = nullptr;
 
+        // LLVM integer types are signless, literals check their range against this signedness
+        bool expected_unsigned = false;
+
         loop_points_t *loop_points = nullptr;
 
-        explicit Context(const std::string &library_name);
+        SymbolTable symbols;
+
+        std::set<std::string> tail_recursive;
+
+        // Opted in with --comptime, the evaluator runs on the calls initializing variables
+        bool comptime = false;
+
+        Evaluator evaluator;
+
+        explicit Context(
+                const std::string &library_name,
+                optimization_level_t optimization_level = optimization_level_t::O1
+        );
 
         virtual ~Context() = default;
 
+        /* ------------------------- Optimization ------------------------- */
+
+        void optimize(llvm::TargetMachine *target_machine);
+
+        /* ------------------------- Ownership ------------------------- */
+
+        llvm::orc::ThreadSafeModule release_module();
+
         /* ------------------------- Blocks ------------------------- */
 
         void operator++();
 
         void operator--();
 
+        void end_scopes(size_t depth);
+
         llvm::ReturnInst *def_return(llvm::Value *value = nullptr);
 
         /* ------------------------- Interfaces ------------------------- */
 
-        CGInterface *def_interface(const std::string &name, CGInterface *interface);
+        CGInterface *def_interface(llvm::StringRef name, CGInterface *interface, llvm::Type *type);
+
+        // Looked up by interned names only
+        CGInterface *interface(llvm::StringRef name);
 
-        CGInterface *interface(const std::string &name);
+        CGInterface *interface(llvm::Type *type);
 
         /* ------------------------- Types ------------------------- */
 
-        llvm::Type *def_type(const std::string &name, llvm::Type *type);
+        llvm::Type *def_type(llvm::StringRef name, llvm::Type *type);
 
-        llvm::Type *type(const std::string &name);
+        // Looked up by interned names only
+        llvm::Type *type(llvm::StringRef name);
 
         llvm::Type *void_type();
 
@@ -95,18 +174,51 @@ namespace silicon::codegen {
 
         llvm::Type *string_type();
 
+        llvm::Type *array_type(llvm::Type *element_type, uint64_t size);
+
+        llvm::Type *slice_type(llvm::Type *element_type);
+
+        llvm::Type *length_type();
+
+        llvm::Type *vector_type(llvm::Type *element_type, unsigned lanes);
+
         bool is_interface(llvm::Type *type);
 
+        bool is_slice(llvm::Type *type);
+
+        bool is_array(llvm::Type *type);
+
+        // Takes the interned name of the type, or of the element type of arrays and slices
+        bool is_unsigned(llvm::StringRef type_name);
+
+        bool is_unsigned(const llvm::Value *value);
+
+        llvm::Value *mark_unsigned(llvm::Value *value, bool is_unsigned = true);
+
         bool compare_types(llvm::Value *value1, llvm::Value *value2);
 
         bool compare_types(llvm::Type *type1, llvm::Type *type2);
 
         llvm::Value *cast_type(CGNode *value, llvm::Type *type);
 
-        llvm::Value *cast_type(llvm::Value *value, llvm::Type *type);
+        llvm::Value *cast_type(llvm::Value *value, llvm::Type *type, bool is_unsigned = false);
 
         std::string stringify_type(llvm::Type *type);
 
+        /* ------------------------- Arrays ------------------------- */
+
+        llvm::Value *array_length(llvm::Value *ptr, llvm::Type *type);
+
+        llvm::Value *element_pointer(llvm::Value *ptr, llvm::Type *type, llvm::Value *index, unsigned count = 1);
+
+        llvm::Value *as_slice(CGNode *value, llvm::Type *type);
+
+        bool bounds_check(llvm::Value *index, llvm::Value *length, unsigned count = 1);
+
+        llvm::Value *heap_slice(llvm::Type *type, llvm::Value *length);
+
+        llvm::CallInst *free_slice(llvm::Value *slice);
+
         /* ------------------------- Literals ------------------------- */
 
         llvm::Value *bool_lit(bool value);
@@ -119,17 +231,26 @@ namespace silicon::codegen {
 
         llvm::Value *float_lit(const std::string &value, llvm::Type *type);
 
+        /* ------------------------- Functions ------------------------- */
+
+        llvm::Function *integer_power(llvm::IntegerType *type, bool is_unsigned);
+
         /* ------------------------- Memory ------------------------- */
 
-        llvm::AllocaInst *get_alloca(const std::string &name);
+        // Variables are looked up by names interned in the arena when their node was built
+        llvm::AllocaInst *get_alloca(llvm::StringRef symbol);
+
+        llvm::Value *alloc(llvm::StringRef name, llvm::Type *type);
 
-        llvm::Value *alloc(const std::string &name, llvm::Type *type);
+        llvm::AllocaInst *entry_alloca(llvm::Type *type, const llvm::Twine &name = "");
+
+        llvm::CallInst *lifetime_start(llvm::AllocaInst *alloca);
+
+        llvm::CallInst *lifetime_end(llvm::AllocaInst *alloca);
 
         llvm::StoreInst *store(llvm::Value *value, llvm::Value *ptr);
 
         llvm::LoadInst *load(llvm::Value *ptr, const std::string &name = "");
-
-        friend class CGCodeBlock;
     };
 
 }
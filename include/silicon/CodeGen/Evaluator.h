@@ -0,0 +1,111 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#ifndef SILICON_EVALUATOR_H
+#define SILICON_EVALUATOR_H
+
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+
+
+namespace silicon::codegen {
+
+    struct pointer_t {
+        pointer_t() = default;
+
+        unsigned slot = 0;
+        unsigned offset = 0; // first cell of the slot the pointer points to
+        llvm::Type *type = nullptr; // null once the pointer has been cast
+    };
+
+    // A local, flattened into one cell per scalar so stores don't rebuild the aggregate around them.
+    // Cells are null until written, aggregates are only built when loaded.
+    struct slot_t {
+        slot_t() = default;
+
+        llvm::Type *type = nullptr;
+        std::vector<llvm::Constant *> cells;
+    };
+
+    struct frame_t {
+        frame_t() = default;
+
+        llvm::DenseMap<const llvm::Value *, llvm::Constant *> values;
+        llvm::DenseMap<const llvm::Value *, pointer_t> pointers;
+        std::vector<slot_t> memory;
+    };
+
+    // Interprets already generated functions on constant arguments so their result can be baked into the caller.
+    // Anything observable outside the function (globals, external calls, traps) gives up and returns null.
+    class Evaluator {
+    protected:
+        using key_t = std::pair<llvm::Function *, std::vector<llvm::Constant *>>;
+
+        std::map<key_t, llvm::Constant *> results;
+
+        std::set<key_t> failures;
+
+        const llvm::DataLayout *data_layout = nullptr;
+
+        unsigned steps = 0;
+
+        unsigned depth = 0;
+
+        // Set when the evaluation ran out of steps or depth, only the failure of the top-level call is final
+        bool limited = false;
+
+        bool run(llvm::Function *function, llvm::ArrayRef<llvm::Constant *> args, llvm::Constant *&result);
+
+        bool execute(frame_t &frame, llvm::Function *function, llvm::Constant *&result);
+
+        bool call(frame_t &frame, llvm::CallInst *inst);
+
+        bool step(frame_t &frame, llvm::Instruction *inst);
+
+        llvm::Constant *get(frame_t &frame, llvm::Value *value);
+
+        pointer_t *get_pointer(frame_t &frame, llvm::Value *value);
+
+        static uint64_t count_cells(llvm::Type *type);
+
+        static llvm::Constant *build(llvm::ArrayRef<llvm::Constant *> cells, unsigned offset, llvm::Type *type);
+
+        static bool flatten(llvm::Constant *value, llvm::MutableArrayRef<llvm::Constant *> cells, unsigned offset);
+
+    public:
+        static const unsigned max_steps = 1000000;
+
+        static const unsigned max_depth = 128;
+
+        Evaluator() = default;
+
+        llvm::Constant *evaluate(llvm::Function *function, llvm::ArrayRef<llvm::Constant *> args);
+    };
+
+}
+
+
+#endif //SILICON_EVALUATOR_H
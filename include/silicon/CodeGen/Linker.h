@@ -0,0 +1,40 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#ifndef SILICON_LINKER_H
+#define SILICON_LINKER_H
+
+
+#include <string>
+#include <vector>
+#include "llvm/ADT/Triple.h"
+#include "silicon/CodeGen/Options.h"
+
+
+namespace silicon::codegen {
+
+    bool link(
+            const std::vector<std::string> &objects,
+            const std::string &output,
+            const llvm::Triple &triple,
+            output_type_t type = output_type_t::EXECUTABLE
+    );
+
+}
+
+
+#endif //SILICON_LINKER_H
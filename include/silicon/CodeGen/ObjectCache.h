@@ -0,0 +1,69 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#ifndef SILICON_OBJECTCACHE_H
+#define SILICON_OBJECTCACHE_H
+
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace silicon::codegen {
+
+    class ObjectCache {
+    protected:
+        std::string directory;
+
+        uint64_t max_size;
+
+        std::mutex mutex;
+
+        std::string entry_path(const std::string &key);
+
+        static void touch(const std::string &entry);
+
+        std::string stats_path();
+
+        void load_stats();
+
+        void save_stats();
+
+    public:
+        uint64_t hits = 0;
+
+        uint64_t misses = 0;
+
+        ObjectCache(std::string directory, uint64_t max_size);
+
+        static std::string key(const std::vector<std::string> &parts);
+
+        bool fetch(const std::string &key, const std::string &object);
+
+        void store(const std::string &key, const std::string &object);
+
+        void prune();
+
+        uint64_t size();
+    };
+
+}
+
+
+#endif //SILICON_OBJECTCACHE_H
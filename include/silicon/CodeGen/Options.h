@@ -0,0 +1,76 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#ifndef SILICON_OPTIONS_H
+#define SILICON_OPTIONS_H
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace silicon::codegen {
+
+    enum class optimization_level_t {
+        O0,
+        O1,
+        O2,
+        O3,
+        Os,
+    };
+
+    enum class output_type_t {
+        OBJECT,
+        EXECUTABLE,
+        SHARED_LIBRARY,
+    };
+
+    struct options_t {
+        options_t() = default;
+
+        std::string output = "output";
+
+        std::string target;
+
+        bool emit_llvm = false;
+
+        output_type_t output_type = output_type_t::EXECUTABLE;
+
+        optimization_level_t optimization_level = optimization_level_t::O1;
+
+        unsigned jobs = 1;
+
+        bool time_trace = false;
+
+        std::string cache_directory;
+
+        uint64_t cache_size = 1024 * 1024 * 1024;
+
+        // Evaluate calls on constant arguments that initialize variables at compile time
+        bool comptime = false;
+
+        // Functions whose recursive calls must all be tail calls
+        std::vector<std::string> tail_recursive;
+    };
+
+    optimization_level_t parse_optimization_level(const std::string &level);
+
+}
+
+
+#endif //SILICON_OPTIONS_H
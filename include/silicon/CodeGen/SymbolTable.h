@@ -0,0 +1,77 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#ifndef SILICON_SYMBOLTABLE_H
+#define SILICON_SYMBOLTABLE_H
+
+
+#include <string>
+#include <vector>
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/IR/Instructions.h"
+
+
+namespace silicon::codegen {
+
+    struct symbol_t {
+        symbol_t() = default;
+
+        uint32_t id = 0;
+        llvm::AllocaInst *alloca = nullptr;
+        llvm::AllocaInst *shadowed = nullptr;
+    };
+
+    // Single table for every scope, interned names map to ids that index the innermost binding directly.
+    // Scopes are markers into the stack of symbols defined so far, popping one restores what it shadowed.
+    // Names are interned in the arena by their nodes, they are hashed and compared by their data pointer.
+    class SymbolTable {
+    protected:
+        llvm::DenseMap<const char *, uint32_t> ids;
+
+        std::vector<llvm::AllocaInst *> bindings;
+
+        std::vector<symbol_t> symbols;
+
+        std::vector<size_t> scopes;
+
+    public:
+        SymbolTable() = default;
+
+        uint32_t id(llvm::StringRef symbol);
+
+        void push();
+
+        void pop();
+
+        size_t depth() const;
+
+        llvm::ArrayRef<symbol_t> scope() const;
+
+        // Symbols of every scope nested deeper than <depth>
+        llvm::ArrayRef<symbol_t> scopes_below(size_t depth) const;
+
+        llvm::AllocaInst *lookup(llvm::StringRef symbol) const;
+
+        void define(llvm::StringRef symbol, llvm::AllocaInst *alloca);
+    };
+
+}
+
+
+#endif //SILICON_SYMBOLTABLE_H
@@ -0,0 +1,84 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#ifndef SILICON_TIMETRACE_H
+#define SILICON_TIMETRACE_H
+
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "llvm/Support/raw_ostream.h"
+
+
+namespace silicon::codegen {
+
+    struct time_trace_event_t {
+        time_trace_event_t() = default;
+
+        std::string name;
+        std::string detail;
+        unsigned thread = 0;
+        std::chrono::steady_clock::time_point begin;
+        std::chrono::steady_clock::time_point end;
+        std::chrono::steady_clock::duration nested{}; // spent in the events nested in this one
+    };
+
+    class TimeTrace {
+    protected:
+        std::chrono::steady_clock::time_point start;
+
+        std::mutex mutex;
+
+        std::vector<time_trace_event_t> events;
+
+        std::map<std::thread::id, std::vector<time_trace_event_t>> stacks;
+
+        std::map<std::thread::id, unsigned> threads;
+
+    public:
+        TimeTrace();
+
+        void begin(const std::string &name, const std::string &detail = "");
+
+        void end();
+
+        void write(llvm::raw_ostream &os);
+
+        void summarize(llvm::raw_ostream &os);
+
+        // Total time in milliseconds of the events with the given name
+        double total(const std::string &name);
+    };
+
+    class TimeScope {
+    protected:
+        TimeTrace *trace;
+
+    public:
+        TimeScope(TimeTrace *trace, const std::string &name, const std::string &detail = "");
+
+        ~TimeScope();
+    };
+
+}
+
+
+#endif //SILICON_TIMETRACE_H
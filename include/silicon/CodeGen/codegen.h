@@ -20,11 +20,25 @@
 
 
 #include <string>
+#include <vector>
+#include "silicon/CodeGen/Options.h"
+#include "silicon/CodeGen/TimeTrace.h"
 
 
 namespace silicon::codegen {
 
-    void codegen(std::string input, std::string output, bool emit_llvm = false);
+    void codegen(std::vector<std::string> inputs, options_t options);
+
+    int run(std::string input, options_t options, std::vector<std::string> arguments = {});
+
+    // Compiles an in-memory source for the host into an object file, without linking or caching.
+    void compile(
+            const std::string &input,
+            const std::string &buffer,
+            const std::string &object,
+            const options_t &options,
+            TimeTrace *time_trace = nullptr
+    );
 
 }
 
@@ -0,0 +1,162 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#include "silicon/Bench/Generators.h"
+
+
+using namespace std;
+using namespace silicon;
+using namespace silicon::bench;
+
+
+string bench::generate_functions(unsigned count) {
+    string source;
+
+    source += "fn f0(x: i64): i64 {\n  return x;\n}\n\n";
+
+    for (unsigned i = 1; i < count; i++) {
+        string index = to_string(i);
+
+        source += "fn f" + index + "(x: i64): i64 {\n";
+        source += "  let y: i64 = x * " + index + " + 1;\n\n";
+        source += "  if (y > 1000) return y - f" + to_string(i - 1) + "(x - 1);\n\n";
+        source += "  return y;\n";
+        source += "}\n\n";
+    }
+
+    source += "fn main(): i32 {\n  f" + to_string(count - 1) + "(10);\n\n  return 0;\n}\n";
+
+    return source;
+}
+
+string bench::generate_nesting(unsigned depth) {
+    string source = "fn nested(x: i64): i64 {\n  let r: i64 = 0;\n\n";
+    string indentation = "  ";
+
+    for (unsigned i = 0; i < depth; i++) {
+        string index = to_string(i);
+
+        if (i % 2 == 0) source += indentation + "if (x > " + index + ") {\n";
+        else source += indentation + "while (r < " + index + ") {\n";
+
+        indentation += "  ";
+
+        source += indentation + "let v" + index + ": i64 = x - " + index + ";\n\n";
+        source += indentation + "r += v" + index + ";\n\n";
+    }
+
+    for (unsigned i = depth; i > 0; i--) {
+        indentation.resize(indentation.size() - 2);
+
+        source += indentation + "}\n";
+    }
+
+    source += "\n  return r;\n}\n\n";
+    source += "fn main(): i32 {\n  nested(10);\n\n  return 0;\n}\n";
+
+    return source;
+}
+
+string bench::generate_interfaces(unsigned count) {
+    const unsigned properties = 4;
+
+    string source;
+
+    for (unsigned i = 0; i < count; i++) {
+        string index = to_string(i);
+
+        source += "interface I" + index;
+
+        if (i > 0) source += " extends I" + to_string(i - 1);
+
+        source += " {\n";
+
+        for (unsigned j = 0; j < properties; j++) source += "  p" + index + "_" + to_string(j) + ": i64;\n";
+
+        source += "}\n\n";
+    }
+
+    string last = to_string(count - 1);
+
+    source += "fn fields(x: i64): i64 {\n  let o: I" + last + " = {\n";
+
+    for (unsigned i = 0; i < count; i++) {
+        for (unsigned j = 0; j < properties; j++) {
+            source += "    p" + to_string(i) + "_" + to_string(j) + ": x + " + to_string(j) + ",\n";
+        }
+    }
+
+    source += "  };\n\n  let r: i64 = 0;\n\n";
+
+    // Every field is read several times, the lookups dominate over the stores.
+    for (unsigned k = 0; k < 4; k++) {
+        for (unsigned i = 0; i < count; i++) {
+            for (unsigned j = 0; j < properties; j++) {
+                source += "  r += o.p" + to_string(i) + "_" + to_string(j) + ";\n";
+            }
+        }
+    }
+
+    source += "\n  return r;\n}\n\n";
+    source += "fn main(): i32 {\n  fields(10);\n\n  return 0;\n}\n";
+
+    return source;
+}
+
+string bench::generate_expressions(unsigned length) {
+    const char *operators[] = {" + ", " - ", " * ", " ^ "};
+
+    string source = "fn expression(x: i64, y: i64): i64 {\n  let r: i64 = x";
+
+    for (unsigned i = 1; i < length; i++) {
+        source += operators[i % 4];
+
+        source += i % 3 == 0 ? "y" : "(x - " + to_string(i) + ")";
+    }
+
+    source += ";\n\n  return r;\n}\n\n";
+    source += "fn main(): i32 {\n  expression(10, 20);\n\n  return 0;\n}\n";
+
+    return source;
+}
+
+string bench::generate_strings(unsigned count) {
+    string source = "extern fn printf(\n  format: string,\n  ...,\n): i32;\n\n";
+
+    source += "fn main(): i32 {\n";
+
+    for (unsigned i = 0; i < count; i++) {
+        string literal = "\"string number " + to_string(i) + ": %lli\\n\"";
+
+        source += "  printf(" + literal + ", " + to_string(i) + ");\n";
+        source += "  printf(" + literal + ", " + to_string(i + 1) + ");\n";
+    }
+
+    source += "\n  return 0;\n}\n";
+
+    return source;
+}
+
+vector<generator_t> bench::generators() {
+    return {
+            {"functions",   2000, generate_functions},
+            {"nesting",     200,  generate_nesting},
+            {"interfaces",  100,  generate_interfaces},
+            {"expressions", 5000, generate_expressions},
+            {"strings",     5000, generate_strings},
+    };
+}
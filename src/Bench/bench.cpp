@@ -0,0 +1,232 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include "config.h"
+#include "utils/CLI11.hpp"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+#include "silicon/Bench/Generators.h"
+#include "silicon/CodeGen/codegen.h"
+#include "silicon/CodeGen/TimeTrace.h"
+
+
+using namespace std;
+using namespace llvm;
+using namespace silicon::bench;
+using namespace silicon::codegen;
+
+
+struct result_t {
+    result_t() = default;
+
+    double parse = 0;
+    double irgen = 0;
+    double optimize = 0;
+    double backend = 0;
+    double total = numeric_limits<double>::max();
+};
+
+// Resets the peak resident set size of the process so each benchmark reports its own (Linux only).
+void reset_peak_rss() {
+    ofstream clear_refs("/proc/self/clear_refs");
+
+    if (clear_refs) clear_refs << "5";
+}
+
+uint64_t peak_rss() {
+    ifstream status("/proc/self/status");
+    string line;
+
+    while (getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) return stoull(line.substr(6)) * 1024;
+    }
+
+    struct rusage usage{};
+
+    getrusage(RUSAGE_SELF, &usage);
+
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return (uint64_t) usage.ru_maxrss * 1024;
+#endif
+}
+
+result_t measure(const string &input, const string &source, const string &object, const options_t &options) {
+    TimeTrace trace;
+
+    const auto begin_time = chrono::steady_clock::now();
+
+    compile(input, source, object, options, &trace);
+
+    const auto end_time = chrono::steady_clock::now();
+
+    // The function pass manager runs while the IR is generated, it is accounted as optimization.
+    double function_passes = trace.total("FunctionPassManager");
+
+    result_t result;
+
+    result.parse = trace.total("Parse");
+    result.irgen = trace.total("IRGen") - function_passes;
+    result.optimize = trace.total("Optimize") + function_passes;
+    result.backend = trace.total("Backend");
+    result.total = chrono::duration<double, milli>(end_time - begin_time).count();
+
+    return result;
+}
+
+int main(int argc, char **argv) {
+    CLI::App app{"Compile-time benchmarks of the Silicon compiler on generated programs"};
+
+    vector<string> names{};
+
+    for (const auto &generator: generators()) names.push_back(generator.name);
+
+    vector<string> filter{};
+    app.add_option(
+                    "benchmark",
+                    filter,
+                    "Benchmarks to run, all of them by default"
+            )
+            ->type_name("name")
+            ->check(CLI::IsMember(names));
+
+    string output = "-";
+    app.add_option(
+                    "-o,--output",
+                    output,
+                    "Write the JSON report to <filename>",
+                    true
+            )
+            ->type_name("filename");
+
+    unsigned scale = 1;
+    app.add_option(
+                    "--scale",
+                    scale,
+                    "Multiply the size of every generated program",
+                    true
+            )
+            ->type_name("N");
+
+    unsigned iterations = 3;
+    app.add_option(
+                    "--iterations",
+                    iterations,
+                    "Compile every program <N> times and report the fastest run",
+                    true
+            )
+            ->type_name("N");
+
+    string optimization_level = "1";
+    app.add_option(
+                    "-O",
+                    optimization_level,
+                    "Optimization level",
+                    true
+            )
+            ->type_name("level")
+            ->check(CLI::IsMember({"0", "1", "2", "3", "s"}));
+
+    CLI11_PARSE(app, argc, argv);
+
+    options_t options;
+
+    options.optimization_level = parse_optimization_level(optimization_level);
+
+    SmallString<128> object;
+
+    if (auto EC = sys::fs::createTemporaryFile("silicon-bench", "o", object)) {
+        errs() << "Could not create temporary file: " << EC.message();
+
+        exit(1);
+    }
+
+    json::Array benchmarks;
+
+    for (const auto &generator: generators()) {
+        if (!filter.empty() && find(filter.begin(), filter.end(), generator.name) == filter.end()) continue;
+
+        unsigned size = generator.size * scale;
+        string input = generator.name + ".si";
+        string source = generator.generate(size);
+
+        errs() << generator.name << " (" << size << ")\n";
+
+        reset_peak_rss();
+
+        result_t best;
+
+        for (unsigned i = 0; i < max(iterations, 1u); i++) {
+            result_t result = measure(input, source, object.str().str(), options);
+
+            if (result.total < best.total) best = result;
+        }
+
+        benchmarks.push_back(json::Object{
+                {"name",           generator.name},
+                {"size",           size},
+                {"source_bytes",   (int64_t) source.size()},
+                {"parse_ms",       best.parse},
+                {"irgen_ms",       best.irgen},
+                {"optimize_ms",    best.optimize},
+                {"backend_ms",     best.backend},
+                {"total_ms",       best.total},
+                {"peak_rss_bytes", (int64_t) peak_rss()},
+        });
+    }
+
+    sys::fs::remove(object);
+
+    json::Object report{
+            {"silicon",            SILICON_VERSION},
+            {"llvm",               LLVM_VERSION_STRING},
+            {"triple",             sys::getProcessTriple()},
+            {"optimization_level", optimization_level},
+            {"scale",              scale},
+            {"iterations",         iterations},
+            {"benchmarks",         std::move(benchmarks)},
+    };
+
+    if (output == "-") {
+        outs() << json::Value(std::move(report)) << "\n";
+
+        return 0;
+    }
+
+    error_code EC;
+    raw_fd_ostream dest(output, EC, sys::fs::F_None);
+
+    if (EC) {
+        errs() << "Could not open file: " << EC.message();
+
+        exit(1);
+    }
+
+    dest << json::Value(std::move(report)) << "\n";
+
+    return 0;
+}
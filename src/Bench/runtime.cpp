@@ -0,0 +1,298 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <vector>
+#include "utils/CLI11.hpp"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/raw_ostream.h"
+
+
+using namespace std;
+using namespace llvm;
+
+
+struct program_t {
+    program_t() = default;
+
+    string name;
+    string silicon;
+    string c;
+};
+
+struct timing_t {
+    timing_t() = default;
+
+    double seconds = numeric_limits<double>::max();
+    string output;
+};
+
+vector<program_t> find_programs(const string &corpus) {
+    vector<program_t> programs{};
+    error_code EC;
+
+    for (sys::fs::directory_iterator it(corpus, EC), end; it != end && !EC; it.increment(EC)) {
+        string path = it->path();
+
+        if (sys::path::extension(path) != ".si") continue;
+
+        SmallString<128> c(path);
+        sys::path::replace_extension(c, "c");
+
+        // Only the programs with a C baseline are comparable.
+        if (!sys::fs::exists(c)) continue;
+
+        program_t program;
+
+        program.name = sys::path::stem(path).str();
+        program.silicon = path;
+        program.c = c.str().str();
+
+        programs.push_back(program);
+    }
+
+    if (EC) {
+        errs() << "Could not read directory \"" << corpus << "\": " << EC.message() << "\n";
+
+        exit(1);
+    }
+
+    std::sort(programs.begin(), programs.end(), [](const auto &a, const auto &b) {
+        return a.name < b.name;
+    });
+
+    return programs;
+}
+
+void execute(const string &program, const vector<string> &arguments, const string &output = "") {
+    vector<StringRef> args{};
+
+    for (const string &argument: arguments) args.emplace_back(argument);
+
+    Optional<StringRef> redirects[] = {None, StringRef(output), None};
+
+    string error;
+
+    int status = sys::ExecuteAndWait(
+            program,
+            args,
+            None,
+            output.empty() ? ArrayRef<Optional<StringRef>>() : redirects,
+            0,
+            0,
+            &error
+    );
+
+    if (status != 0) {
+        errs() << "Command \"" << program << "\" failed";
+
+        if (!error.empty()) errs() << ": " << error;
+
+        errs() << "\n";
+
+        exit(1);
+    }
+}
+
+timing_t run(const string &executable, unsigned runs) {
+    SmallString<128> output;
+
+    if (auto EC = sys::fs::createTemporaryFile("silicon-bench", "out", output)) {
+        errs() << "Could not create temporary file: " << EC.message() << "\n";
+
+        exit(1);
+    }
+
+    timing_t timing;
+
+    for (unsigned i = 0; i < max(runs, 1u); i++) {
+        const auto begin_time = chrono::steady_clock::now();
+
+        execute(executable, {executable}, output.str().str());
+
+        const auto end_time = chrono::steady_clock::now();
+
+        timing.seconds = min(timing.seconds, chrono::duration<double>(end_time - begin_time).count());
+    }
+
+    if (auto buffer = MemoryBuffer::getFile(output)) timing.output = (*buffer)->getBuffer().str();
+
+    sys::fs::remove(output);
+
+    return timing;
+}
+
+int main(int argc, char **argv) {
+    CLI::App app{"Runtime benchmarks of Silicon programs against their C baselines"};
+
+    string corpus;
+    app.add_option(
+                    "corpus",
+                    corpus,
+                    "Directory of <name>.si programs and their <name>.c baselines"
+            )
+            ->type_name("directory")
+            ->check(CLI::ExistingDirectory)
+            ->required();
+
+    string silicon;
+    app.add_option(
+                    "--silicon",
+                    silicon,
+                    "Silicon compiler"
+            )
+            ->type_name("file")
+            ->check(CLI::ExistingFile)
+            ->required();
+
+    string cc = "cc";
+    app.add_option(
+                    "--cc",
+                    cc,
+                    "C compiler of the baselines",
+                    true
+            )
+            ->type_name("file");
+
+    vector<string> levels{"0", "1", "2", "3"};
+    app.add_option(
+                    "-O",
+                    levels,
+                    "Optimization levels to compare, both compilers use the same one",
+                    true
+            )
+            ->type_name("level")
+            ->check(CLI::IsMember({"0", "1", "2", "3", "s"}));
+
+    unsigned runs = 3;
+    app.add_option(
+                    "--runs",
+                    runs,
+                    "Run every executable <N> times and keep the fastest run",
+                    true
+            )
+            ->type_name("N");
+
+    string report;
+    app.add_option(
+                    "-o,--output",
+                    report,
+                    "Also write the results as JSON to <filename>"
+            )
+            ->type_name("filename");
+
+    CLI11_PARSE(app, argc, argv);
+
+    auto cc_path = sys::findProgramByName(cc);
+
+    if (!cc_path) {
+        errs() << "Could not find C compiler \"" << cc << "\"\n";
+
+        exit(1);
+    }
+
+    SmallString<128> directory;
+
+    if (auto EC = sys::fs::createUniqueDirectory("silicon-bench", directory)) {
+        errs() << "Could not create temporary directory: " << EC.message() << "\n";
+
+        exit(1);
+    }
+
+    json::Array results;
+
+    outs() << left_justify("Benchmark", 24)
+           << right_justify("Level", 6)
+           << right_justify("Silicon (s)", 14)
+           << right_justify("C (s)", 14)
+           << right_justify("Ratio", 9)
+           << "\n";
+
+    for (const auto &program: find_programs(corpus)) {
+        for (const string &level: levels) {
+            SmallString<128> silicon_executable(directory);
+            sys::path::append(silicon_executable, program.name + "-silicon-O" + level);
+
+            SmallString<128> c_executable(directory);
+            sys::path::append(c_executable, program.name + "-c-O" + level);
+
+            execute(silicon, {silicon, "-O" + level, "-o", silicon_executable.str().str(), program.silicon});
+
+            execute(*cc_path, {*cc_path, "-O" + level, "-o", c_executable.str().str(), program.c, "-lm"});
+
+            timing_t silicon_timing = run(silicon_executable.str().str(), runs);
+            timing_t c_timing = run(c_executable.str().str(), runs);
+
+            double ratio = c_timing.seconds > 0 ? silicon_timing.seconds / c_timing.seconds : 0;
+
+            // Both programs print the same checksum, a mismatch means the comparison is meaningless.
+            bool matches = silicon_timing.output == c_timing.output;
+
+            outs() << format(
+                    "%-24s %5s %13.3f %13.3f %8.2fx%s\n",
+                    program.name.c_str(),
+                    ("-O" + level).c_str(),
+                    silicon_timing.seconds,
+                    c_timing.seconds,
+                    ratio,
+                    matches ? "" : "  (output mismatch)"
+            );
+
+            results.push_back(json::Object{
+                    {"name",               program.name},
+                    {"optimization_level", level},
+                    {"silicon_seconds",    silicon_timing.seconds},
+                    {"c_seconds",          c_timing.seconds},
+                    {"ratio",              ratio},
+                    {"output_matches",     matches},
+            });
+
+            sys::fs::remove(silicon_executable);
+            sys::fs::remove(c_executable);
+        }
+    }
+
+    sys::fs::remove(directory);
+
+    if (report.empty()) return 0;
+
+    error_code EC;
+    raw_fd_ostream dest(report, EC, sys::fs::F_None);
+
+    if (EC) {
+        errs() << "Could not open file: " << EC.message();
+
+        exit(1);
+    }
+
+    dest << json::Value(json::Object{
+            {"cc",      cc},
+            {"runs",    runs},
+            {"results", std::move(results)},
+    }) << "\n";
+
+    return 0;
+}
@@ -16,7 +16,9 @@
 
 
 #include "silicon/CodeGen/CGBinaryOperation.h"
+#include "silicon/CodeGen/CGFunctionCall.h"
 #include "silicon/CodeGen/CGType.h"
+#include "silicon/CodeGen/CGUnaryOperation.h"
 #include "silicon/CodeGen/CGVariable.h"
 #include "silicon/CodeGen/CGVariableDefinition.h"
 
@@ -27,7 +29,16 @@ using namespace silicon::codegen;
 using namespace silicon::parser::AST;
 
 
-CGBinaryOperation::CGBinaryOperation(BinaryOperation *node) : Node{node}, BinaryOperation{node} {
+CGBinaryOperation::CGBinaryOperation(BinaryOperation *node) :
+        Node{node},
+        BinaryOperation{node},
+        cg_left(resolve(left)),
+        cg_right(resolve(right)) {
+    if (op == binary_operation_t::ASSIGN
+        && cg_left->is_node(node_t::VARIABLE_DEFINITION)
+        && cg_right->is_node(node_t::FUNCTION_CALL)) {
+        static_cast<CGFunctionCall *>(cg_right)->initializer = true;
+    }
 }
 
 string CGBinaryOperation::stringify_operator() {
@@ -117,10 +128,14 @@ Value *CGBinaryOperation::codegen(Context *ctx) {
             return gte(ctx);
         case binary_operation_t::BIGGER:
             return gt(ctx);
-        case binary_operation_t::STAR_STAR:
         case binary_operation_t::AND_AND:
+            return logical_and(ctx);
         case binary_operation_t::OR_OR:
+            return logical_or(ctx);
         case binary_operation_t::CAST:
+            return cast(ctx);
+        case binary_operation_t::STAR_STAR:
+            return power(ctx);
         default:
             fail("Unsupported binary operation!");
     }
@@ -134,13 +149,14 @@ void CGBinaryOperation::unsupported_op(Context *ctx, llvm::Type *t1, llvm::Type
     );
 }
 
-value_pair_t *CGBinaryOperation::parse_pair(Context *ctx) {
-    auto *pair = new value_pair_t();
+value_pair_t CGBinaryOperation::parse_pair(Context *ctx) {
+    value_pair_t pair;
 
-    auto *l = dynamic_cast<CGNode *>(left);
-    auto *r = dynamic_cast<CGNode *>(right);
+    CGNode *l = cg_left;
+    CGNode *r = cg_right;
 
     llvm::Type *expected_type = ctx->expected_type;
+    bool expected_unsigned = ctx->expected_unsigned;
 
     bool isLeftDynamic = l->is_node(node_t::NUMBER_LIT) || l->is_node(node_t::NULL_PTR);
     bool isRightDynamic = r->is_node(node_t::NUMBER_LIT) || r->is_node(node_t::NULL_PTR);
@@ -148,41 +164,100 @@ value_pair_t *CGBinaryOperation::parse_pair(Context *ctx) {
     if (isLeftDynamic) {
         if (isRightDynamic) l->codegen(ctx);
         else {
-            pair->right = r->codegen(ctx);
+            pair.right = r->codegen(ctx);
 
-            ctx->expected_type = pair->right->getType();
+            ctx->expected_type = pair.right->getType();
+            ctx->expected_unsigned = ctx->is_unsigned(pair.right);
 
-            pair->left = l->codegen(ctx);
+            pair.left = l->codegen(ctx);
 
             ctx->expected_type = expected_type;
+            ctx->expected_unsigned = expected_unsigned;
         }
     } else if (isRightDynamic) {
-        pair->left = l->codegen(ctx);
+        pair.left = l->codegen(ctx);
 
-        ctx->expected_type = pair->left->getType();
+        ctx->expected_type = pair.left->getType();
+        ctx->expected_unsigned = ctx->is_unsigned(pair.left);
 
-        pair->right = r->codegen(ctx);
+        pair.right = r->codegen(ctx);
 
         ctx->expected_type = expected_type;
+        ctx->expected_unsigned = expected_unsigned;
     }
 
-    if (!pair->left) pair->left = l->codegen(ctx);
+    if (!pair.left) pair.left = l->codegen(ctx);
 
-    if (!pair->right) pair->right = r->codegen(ctx);
+    if (!pair.right) pair.right = r->codegen(ctx);
+
+    bool is_left_unsigned = ctx->is_unsigned(pair.left);
+    bool is_right_unsigned = ctx->is_unsigned(pair.right);
+
+    // Constants take the signedness of the other side
+    if (is_left_unsigned != is_right_unsigned
+        && pair.left->getType()->isIntegerTy()
+        && pair.right->getType()->isIntegerTy()
+        && !isa<Constant>(pair.left)
+        && !isa<Constant>(pair.right)) {
+        fail("TypeError: Expected both sides of the operation to have the same signedness.");
+    }
+
+    pair.is_unsigned = is_left_unsigned || is_right_unsigned;
 
     return pair;
 }
 
+bool CGBinaryOperation::is_cheap(CGNode *node, unsigned &budget) {
+    if (budget == 0) return false;
+
+    budget--;
+
+    if (node->is_node(node_t::BOOLEAN_LIT) || node->is_node(node_t::NUMBER_LIT)) return true;
+
+    if (node->is_node(node_t::VARIABLE)) {
+        // Loading a local, or one of its fields, has no side effect.
+        auto *variable = static_cast<CGVariable *>(node);
+
+        return !variable->context || is_cheap(resolve(variable->context), budget);
+    }
+
+    if (node->is_node(node_t::UNARY_OP)) {
+        auto *operation = static_cast<CGUnaryOperation *>(node);
+
+        if (operation->op != unary_operation_t::MINUS && operation->op != unary_operation_t::NOT) return false;
+
+        return is_cheap(resolve(operation->node), budget);
+    }
+
+    if (node->is_node(node_t::BINARY_OP)) {
+        auto *operation = static_cast<CGBinaryOperation *>(node);
+
+        switch (operation->op) {
+            // Assignments have side effects, divisions can trap.
+            case binary_operation_t::ASSIGN:
+            case binary_operation_t::SLASH:
+            case binary_operation_t::PERCENT:
+            case binary_operation_t::STAR_STAR:
+                return false;
+            default:
+                return is_cheap(operation->cg_left, budget) && is_cheap(operation->cg_right, budget);
+        }
+    }
+
+    return false;
+}
+
 Value *CGBinaryOperation::assign(Context *ctx) {
-    auto *l = dynamic_cast<CGNode *>(left);
-    auto *r = dynamic_cast<CGNode *>(right);
+    CGNode *l = cg_left;
+    CGNode *r = cg_right;
 
     llvm::Type *expected_type = ctx->expected_type;
+    bool expected_unsigned = ctx->expected_unsigned;
 
     llvm::Type *llvm_type;
 
     if (l->is_node(node_t::VARIABLE_DEFINITION)) {
-        auto *lVD = dynamic_cast<CGVariableDefinition *>(l);
+        auto *lVD = static_cast<CGVariableDefinition *>(l);
 
         llvm_type = lVD->get_type(ctx);
 
@@ -195,6 +270,9 @@ Value *CGBinaryOperation::assign(Context *ctx) {
 
             ctx->expected_type = expected_type;
 
+            // Inferred from the value, signedness included
+            ctx->mark_unsigned(alloca, ctx->is_unsigned(rV));
+
             StoreInst *store = ctx->store(rV, alloca);
 
             unsigned alignment = alloca->getAlignment();
@@ -207,8 +285,11 @@ Value *CGBinaryOperation::assign(Context *ctx) {
         auto *alloca = (AllocaInst *)lVD->codegen(ctx);
 
         ctx->expected_type = llvm_type;
+        ctx->expected_unsigned = ctx->is_unsigned(alloca);
 
-        Value *rV = r->codegen(ctx);
+        Value *rV = ctx->as_slice(r, llvm_type);
+
+        if (!rV) rV = r->codegen(ctx);
 
         if (!ctx->compare_types(rV->getType(), ctx->expected_type)) {
             fail(
@@ -221,6 +302,7 @@ Value *CGBinaryOperation::assign(Context *ctx) {
         }
 
         ctx->expected_type = expected_type;
+        ctx->expected_unsigned = expected_unsigned;
 
         StoreInst *store = ctx->store(rV, alloca);
 
@@ -232,13 +314,16 @@ Value *CGBinaryOperation::assign(Context *ctx) {
     }
 
     if (l->is_node(node_t::VARIABLE)) {
-        auto *lV = dynamic_cast<CGVariable *>(l);
+        auto *lV = static_cast<CGVariable *>(l);
 
         llvm_type = lV->get_type(ctx);
 
         ctx->expected_type = llvm_type;
+        ctx->expected_unsigned = ctx->is_unsigned(lV->get_pointer(ctx));
 
-        Value *rV = r->codegen(ctx);
+        Value *rV = llvm_type ? ctx->as_slice(r, llvm_type) : nullptr;
+
+        if (!rV) rV = r->codegen(ctx);
 
         if (llvm_type && !ctx->compare_types(rV->getType(), ctx->expected_type)) {
             fail(
@@ -251,254 +336,402 @@ Value *CGBinaryOperation::assign(Context *ctx) {
         }
 
         ctx->expected_type = expected_type;
+        ctx->expected_unsigned = expected_unsigned;
 
         ctx->store(rV, lV->get_pointer(ctx));
 
         return rV;
     }
 
+    if (l->is_node(node_t::FUNCTION_CALL)) {
+        Value *pointer = static_cast<CGFunctionCall *>(l)->get_pointer(ctx);
+
+        llvm_type = pointer->getType()->getPointerElementType();
+
+        ctx->expected_type = llvm_type;
+        ctx->expected_unsigned = ctx->is_unsigned(pointer);
+
+        Value *rV = r->codegen(ctx);
+
+        if (!ctx->compare_types(rV->getType(), ctx->expected_type)) {
+            fail(
+                    "TypeError: Expected the right side of the operation to be <"
+                    + ctx->stringify_type(llvm_type)
+                    + ">, got <"
+                    + ctx->stringify_type(rV->getType())
+                    + "> instead."
+            );
+        }
+
+        ctx->expected_type = expected_type;
+        ctx->expected_unsigned = expected_unsigned;
+
+        ctx->store(rV, pointer);
+
+        return rV;
+    }
+
     fail("Expected left side of the equation to be a variable");
 }
 
 Value *CGBinaryOperation::multiply(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) return ctx->llvm_ir_builder.CreateNSWMul(left, right);
+    if (type->isIntOrIntVectorTy()) {
+        // Unsigned arithmetic wraps around
+        if (pair.is_unsigned) return ctx->mark_unsigned(ctx->llvm_ir_builder.CreateMul(left, right));
 
-    if (type->isFloatingPointTy()) return ctx->llvm_ir_builder.CreateFMul(left, right);
+        return ctx->llvm_ir_builder.CreateNSWMul(left, right);
+    }
+
+    if (type->isFPOrFPVectorTy()) return ctx->llvm_ir_builder.CreateFMul(left, right);
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::divide(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) {
-        // TODO: unsigned: ctx->llvm_ir_builder.CreateUDiv(left, right)
+    if (type->isIntOrIntVectorTy()) {
+        if (pair.is_unsigned) return ctx->mark_unsigned(ctx->llvm_ir_builder.CreateUDiv(left, right));
+
         return ctx->llvm_ir_builder.CreateSDiv(left, right);
     }
 
-    if (type->isFloatingPointTy()) return ctx->llvm_ir_builder.CreateFDiv(left, right);
+    if (type->isFPOrFPVectorTy()) return ctx->llvm_ir_builder.CreateFDiv(left, right);
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::remainder(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) {
-        // TODO: unsigned: ctx->llvm_ir_builder.CreateURem(left, right)
+    if (type->isIntOrIntVectorTy()) {
+        if (pair.is_unsigned) return ctx->mark_unsigned(ctx->llvm_ir_builder.CreateURem(left, right));
+
         return ctx->llvm_ir_builder.CreateSRem(left, right);
     }
 
-    if (type->isFloatingPointTy()) return ctx->llvm_ir_builder.CreateFRem(left, right);
+    if (type->isFPOrFPVectorTy()) return ctx->llvm_ir_builder.CreateFRem(left, right);
 
     unsupported_op(ctx, type, right->getType());
 }
 
+Value *CGBinaryOperation::power(Context *ctx) {
+    value_pair_t pair = parse_pair(ctx);
+
+    Value *left = pair.left;
+    Value *right = pair.right;
+
+    llvm::Type *type = left->getType();
+    llvm::Type *exponent_type = right->getType();
+
+    if (type->isIntegerTy() && exponent_type->isIntegerTy()) {
+        // Negative exponents are left to the runtime routine
+        auto *exponent = dyn_cast<ConstantInt>(right);
+
+        if (exponent && (pair.is_unsigned || !exponent->isNegative()) && exponent->getValue().getActiveBits() <= 64)
+            return ctx->mark_unsigned(power_chain(ctx, left, exponent->getZExtValue()), pair.is_unsigned);
+
+        if (pair.is_unsigned) right = ctx->llvm_ir_builder.CreateZExtOrTrunc(right, type);
+        else right = ctx->llvm_ir_builder.CreateSExtOrTrunc(right, type);
+
+        llvm::Function *function = ctx->integer_power(llvm::cast<IntegerType>(type), pair.is_unsigned);
+
+        CallInst *call = ctx->llvm_ir_builder.CreateCall(function, {left, right}, "pow");
+
+        call->setCallingConv(function->getCallingConv());
+
+        return ctx->mark_unsigned(call, pair.is_unsigned);
+    }
+
+    if (!type->isFPOrFPVectorTy()) unsupported_op(ctx, type, exponent_type);
+
+    auto *constant = dyn_cast<Constant>(right);
+
+    if (constant && exponent_type->isVectorTy()) constant = constant->getSplatValue();
+
+    // Small integral exponents are expanded into multiplications, x ** 2 is x * x
+    if (auto *exponent = dyn_cast_or_null<ConstantFP>(constant)) {
+        const APFloat &value = exponent->getValueAPF();
+
+        if (value.isInteger() && abs(value.convertToDouble()) <= 64) {
+            auto n = (int64_t) value.convertToDouble();
+
+            Value *result = power_chain(ctx, left, (uint64_t) abs(n));
+
+            if (n >= 0) return result;
+
+            return ctx->llvm_ir_builder.CreateFDiv(ConstantFP::get(type, 1.0), result);
+        }
+    }
+
+    llvm::Module *module = ctx->llvm_module.get();
+
+    if (exponent_type->isIntegerTy()) {
+        if (ctx->is_unsigned(right)) right = ctx->llvm_ir_builder.CreateZExtOrTrunc(right, ctx->int_type(32));
+        else right = ctx->llvm_ir_builder.CreateSExtOrTrunc(right, ctx->int_type(32));
+
+        return ctx->llvm_ir_builder.CreateCall(Intrinsic::getDeclaration(module, Intrinsic::powi, {type}), {left, right});
+    }
+
+    if (!ctx->compare_types(type, exponent_type)) unsupported_op(ctx, type, exponent_type);
+
+    return ctx->llvm_ir_builder.CreateCall(Intrinsic::getDeclaration(module, Intrinsic::pow, {type}), {left, right});
+}
+
+// Square and multiply: x ** 13 is x ** 8 * x ** 4 * x, squarings shared
+Value *CGBinaryOperation::power_chain(Context *ctx, Value *base, uint64_t exponent) {
+    bool is_float = base->getType()->isFPOrFPVectorTy();
+
+    auto multiply = [&](Value *a, Value *b) {
+        if (is_float) return ctx->llvm_ir_builder.CreateFMul(a, b);
+
+        return ctx->llvm_ir_builder.CreateMul(a, b);
+    };
+
+    Value *result = nullptr;
+
+    while (exponent) {
+        if (exponent & 1) result = result ? multiply(result, base) : base;
+
+        exponent >>= 1;
+
+        if (exponent) base = multiply(base, base);
+    }
+
+    if (result) return result;
+
+    if (is_float) return ConstantFP::get(base->getType(), 1.0);
+
+    return ConstantInt::get(base->getType(), 1);
+}
+
 Value *CGBinaryOperation::add(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) return ctx->llvm_ir_builder.CreateNSWAdd(left, right);
+    if (type->isIntOrIntVectorTy()) {
+        // Unsigned arithmetic wraps around
+        if (pair.is_unsigned) return ctx->mark_unsigned(ctx->llvm_ir_builder.CreateAdd(left, right));
+
+        return ctx->llvm_ir_builder.CreateNSWAdd(left, right);
+    }
 
-    if (type->isFloatingPointTy()) return ctx->llvm_ir_builder.CreateFAdd(left, right);
+    if (type->isFPOrFPVectorTy()) return ctx->llvm_ir_builder.CreateFAdd(left, right);
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::sub(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) return ctx->llvm_ir_builder.CreateNSWSub(left, right);
+    if (type->isIntOrIntVectorTy()) {
+        // Unsigned arithmetic wraps around
+        if (pair.is_unsigned) return ctx->mark_unsigned(ctx->llvm_ir_builder.CreateSub(left, right));
+
+        return ctx->llvm_ir_builder.CreateNSWSub(left, right);
+    }
 
-    if (type->isFloatingPointTy()) return ctx->llvm_ir_builder.CreateFSub(left, right);
+    if (type->isFPOrFPVectorTy()) return ctx->llvm_ir_builder.CreateFSub(left, right);
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::bw_xor(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) return ctx->llvm_ir_builder.CreateXor(left, right);
+    if (type->isIntOrIntVectorTy())
+        return ctx->mark_unsigned(ctx->llvm_ir_builder.CreateXor(left, right), pair.is_unsigned);
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::bw_and(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) return ctx->llvm_ir_builder.CreateAnd(left, right);
+    if (type->isIntOrIntVectorTy())
+        return ctx->mark_unsigned(ctx->llvm_ir_builder.CreateAnd(left, right), pair.is_unsigned);
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::bw_or(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) return ctx->llvm_ir_builder.CreateOr(left, right);
+    if (type->isIntOrIntVectorTy())
+        return ctx->mark_unsigned(ctx->llvm_ir_builder.CreateOr(left, right), pair.is_unsigned);
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::bw_left_shift(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) return ctx->llvm_ir_builder.CreateShl(left, right);
+    if (type->isIntOrIntVectorTy())
+        return ctx->mark_unsigned(ctx->llvm_ir_builder.CreateShl(left, right), pair.is_unsigned);
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::bw_right_shift(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) return ctx->llvm_ir_builder.CreateAShr(left, right);
+    if (type->isIntOrIntVectorTy()) {
+        // Unsigned values have no sign to extend
+        if (pair.is_unsigned) return ctx->mark_unsigned(ctx->llvm_ir_builder.CreateLShr(left, right));
+
+        return ctx->llvm_ir_builder.CreateAShr(left, right);
+    }
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::bw_u_right_shift(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) return ctx->llvm_ir_builder.CreateLShr(left, right);
+    if (type->isIntOrIntVectorTy())
+        return ctx->mark_unsigned(ctx->llvm_ir_builder.CreateLShr(left, right), pair.is_unsigned);
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::lt(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) {
-        // TODO: unsigned: ctx->llvm_ir_builder.CreateICmpULT(l, r)
+    if (type->isIntOrIntVectorTy()) {
+        if (pair.is_unsigned) return ctx->llvm_ir_builder.CreateICmpULT(left, right);
+
         return ctx->llvm_ir_builder.CreateICmpSLT(left, right);
     }
 
-    if (type->isFloatingPointTy()) return ctx->llvm_ir_builder.CreateFCmpOLT(left, right);
+    if (type->isFPOrFPVectorTy()) return ctx->llvm_ir_builder.CreateFCmpOLT(left, right);
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::lte(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) {
-        // TODO: unsigned: ctx->llvm_ir_builder.CreateICmpULE(left, right)
+    if (type->isIntOrIntVectorTy()) {
+        if (pair.is_unsigned) return ctx->llvm_ir_builder.CreateICmpULE(left, right);
+
         return ctx->llvm_ir_builder.CreateICmpSLE(left, right);
     }
 
-    if (type->isFloatingPointTy()) return ctx->llvm_ir_builder.CreateFCmpOLE(left, right);
+    if (type->isFPOrFPVectorTy()) return ctx->llvm_ir_builder.CreateFCmpOLE(left, right);
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::eq(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
@@ -507,18 +740,18 @@ Value *CGBinaryOperation::eq(Context *ctx) {
 
 //    if (type->isVoidTy()) return ctx->bool_lit(true)->codegen(ctx);
 
-    if (type->isIntegerTy()) return ctx->llvm_ir_builder.CreateICmpEQ(left, right);
+    if (type->isIntOrIntVectorTy()) return ctx->llvm_ir_builder.CreateICmpEQ(left, right);
 
-    if (type->isFloatingPointTy()) return ctx->llvm_ir_builder.CreateFCmpOEQ(left, right);
+    if (type->isFPOrFPVectorTy()) return ctx->llvm_ir_builder.CreateFCmpOEQ(left, right);
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::ne(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
@@ -527,76 +760,140 @@ Value *CGBinaryOperation::ne(Context *ctx) {
 
 //    if (type->isVoidTy()) return ctx->bool_lit(false)->codegen(ctx);
 
-    if (type->isIntegerTy()) return ctx->llvm_ir_builder.CreateICmpNE(left, right);
+    if (type->isIntOrIntVectorTy()) return ctx->llvm_ir_builder.CreateICmpNE(left, right);
 
-    if (type->isFloatingPointTy()) return ctx->llvm_ir_builder.CreateFCmpONE(left, right);
+    if (type->isFPOrFPVectorTy()) return ctx->llvm_ir_builder.CreateFCmpONE(left, right);
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::gte(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) {
-        // TODO: unsigned: ctx->llvm_ir_builder.CreateICmpUGE(left, right)
+    if (type->isIntOrIntVectorTy()) {
+        if (pair.is_unsigned) return ctx->llvm_ir_builder.CreateICmpUGE(left, right);
+
         return ctx->llvm_ir_builder.CreateICmpSGE(left, right);
     }
 
-    if (type->isFloatingPointTy()) return ctx->llvm_ir_builder.CreateFCmpOGE(left, right);
+    if (type->isFPOrFPVectorTy()) return ctx->llvm_ir_builder.CreateFCmpOGE(left, right);
 
     unsupported_op(ctx, type, right->getType());
 }
 
 Value *CGBinaryOperation::gt(Context *ctx) {
-    value_pair_t *pair = parse_pair(ctx);
+    value_pair_t pair = parse_pair(ctx);
 
-    Value *left = pair->left;
-    Value *right = pair->right;
+    Value *left = pair.left;
+    Value *right = pair.right;
 
     if (!ctx->compare_types(left, right))
         fail("TypeError: Expected both sides of the operation to have the same type.");
 
     llvm::Type *type = left->getType();
 
-    if (type->isIntegerTy()) {
-        // TODO: unsigned: ctx->llvm_ir_builder.CreateICmpUGT(left, right)
+    if (type->isIntOrIntVectorTy()) {
+        if (pair.is_unsigned) return ctx->llvm_ir_builder.CreateICmpUGT(left, right);
+
         return ctx->llvm_ir_builder.CreateICmpSGT(left, right);
     }
 
-    if (type->isFloatingPointTy()) return ctx->llvm_ir_builder.CreateFCmpOGT(left, right);
+    if (type->isFPOrFPVectorTy()) return ctx->llvm_ir_builder.CreateFCmpOGT(left, right);
 
     unsupported_op(ctx, type, right->getType());
 }
 
+Value *CGBinaryOperation::short_circuit(Context *ctx, bool is_or) {
+    llvm::Type *bool_type = ctx->bool_type();
+
+    Value *left = ctx->cast_type(cg_left->codegen(ctx), bool_type);
+
+    if (!left) fail("TypeError: Expected the left side of the operation to be a boolean");
+
+    // A cheap right side without side effects is always evaluated, a select is cheaper than a branch.
+    unsigned budget = 8;
+
+    if (is_cheap(cg_right, budget)) {
+        Value *right = ctx->cast_type(cg_right->codegen(ctx), bool_type);
+
+        if (!right) fail("TypeError: Expected the right side of the operation to be a boolean");
+
+        if (is_or) return ctx->llvm_ir_builder.CreateSelect(left, ctx->bool_lit(true), right);
+
+        return ctx->llvm_ir_builder.CreateSelect(left, right, ctx->bool_lit(false));
+    }
+
+    llvm::Function *function = ctx->llvm_ir_builder.GetInsertBlock()->getParent();
+
+    BasicBlock *leftBB = ctx->llvm_ir_builder.GetInsertBlock();
+    BasicBlock *rightBB = BasicBlock::Create(ctx->llvm_ctx, is_or ? "or.rhs" : "and.rhs", function);
+    BasicBlock *afterBB = BasicBlock::Create(ctx->llvm_ctx, is_or ? "or.end" : "and.end", function);
+
+    if (is_or) ctx->llvm_ir_builder.CreateCondBr(left, afterBB, rightBB);
+    else ctx->llvm_ir_builder.CreateCondBr(left, rightBB, afterBB);
+
+    ctx->llvm_ir_builder.SetInsertPoint(rightBB);
+
+    Value *right = ctx->cast_type(cg_right->codegen(ctx), bool_type);
+
+    if (!right) fail("TypeError: Expected the right side of the operation to be a boolean");
+
+    // The right side may have added blocks of its own.
+    rightBB = ctx->llvm_ir_builder.GetInsertBlock();
+
+    ctx->llvm_ir_builder.CreateBr(afterBB);
+
+    ctx->llvm_ir_builder.SetInsertPoint(afterBB);
+
+    PHINode *phi = ctx->llvm_ir_builder.CreatePHI(bool_type, 2, is_or ? "or" : "and");
+
+    phi->addIncoming(ctx->bool_lit(is_or), leftBB);
+    phi->addIncoming(right, rightBB);
+
+    return phi;
+}
+
+Value *CGBinaryOperation::logical_and(Context *ctx) {
+    return short_circuit(ctx, false);
+}
+
+Value *CGBinaryOperation::logical_or(Context *ctx) {
+    return short_circuit(ctx, true);
+}
+
 Value *CGBinaryOperation::cast(Context *ctx) {
     // TODO: use ctx->cast_type()
-    auto *r = dynamic_cast<CGNode *>(right);
+    CGNode *r = cg_right;
 
     if (!r->is_node(node_t::TYPE)) fail("Error: Expected cast operation's right hand value to be a type");
 
-    auto *l = dynamic_cast<CGNode *>(left);
+    CGNode *l = cg_left;
 
     llvm::Value *v;
-    llvm::Type *llvm_t = dynamic_cast<CGType *>(right)->typegen(ctx);
+    llvm::Type *llvm_t = static_cast<CGType *>(r)->typegen(ctx);
+    bool is_unsigned = static_cast<CGType *>(r)->is_unsigned(ctx);
 
     if (l->is_node(node_t::NUMBER_LIT)
         && (llvm_t->isIntegerTy()
             || llvm_t->isFloatingPointTy())) {
         llvm::Type *expected_type = ctx->expected_type;
+        bool expected_unsigned = ctx->expected_unsigned;
 
         ctx->expected_type = llvm_t;
+        ctx->expected_unsigned = is_unsigned;
 
         v = l->codegen(ctx);
 
         ctx->expected_type = expected_type;
+        ctx->expected_unsigned = expected_unsigned;
 
         return v;
     }
@@ -605,7 +902,8 @@ Value *CGBinaryOperation::cast(Context *ctx) {
 
     llvm::Type *t = v->getType();
 
-    if (ctx->compare_types(t, llvm_t)) return v;
+    // Between signed and unsigned integers of the same width only the interpretation changes
+    if (ctx->compare_types(t, llvm_t)) return ctx->mark_unsigned(v, is_unsigned && t->isIntegerTy());
 
     if (llvm_t->isIntegerTy(1)) {
         if (t->isVoidTy()) return ctx->bool_lit(false);
@@ -623,15 +921,17 @@ Value *CGBinaryOperation::cast(Context *ctx) {
         );
     }
 
-    return ctx->llvm_ir_builder.CreateCast(
+    Value *cast = ctx->llvm_ir_builder.CreateCast(
             llvm::CastInst::getCastOpcode(
                     v,
-                    true,
+                    !ctx->is_unsigned(v),
                     llvm_t,
-                    true
+                    !is_unsigned
             ),
             v,
             llvm_t,
             "cast"
     );
+
+    return ctx->mark_unsigned(cast, is_unsigned && llvm_t->isIntegerTy());
 }
@@ -31,5 +31,7 @@ Value *CGBreak::codegen(Context *ctx) {
 
     if (!loop_points) fail("Error: Unexpected \"break\" outside loop");
 
+    ctx->end_scopes(loop_points->depth);
+
     return ctx->llvm_ir_builder.CreateBr(loop_points->break_point);
 }
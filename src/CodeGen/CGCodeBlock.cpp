@@ -25,57 +25,32 @@ using namespace silicon::parser::AST;
 
 
 CGCodeBlock::CGCodeBlock(CodeBlock *node) : Node{node}, CodeBlock{node} {
+    cg_statements.reserve(statements.size());
+
+    for (auto &statement: statements) cg_statements.push_back(resolve(statement));
 }
 
 Value *CGCodeBlock::codegen(Context *ctx) {
-    parent = ctx->code_block;
+    // Only the nodes of the library itself are traced, the nested ones are part of their time.
+    bool top_level = ctx->symbols.depth() == 0;
+
+    ctx->operator++();
 
-    ctx->code_block = this;
+    for (CGNode *statement: cg_statements) {
+        TimeScope scope(top_level ? ctx->time_trace : nullptr, "Top-level node");
 
-    for (auto &statement: statements) {
-        Value *value = dynamic_cast<CGNode *>(statement)->codegen(ctx);
+        Value *value = statement->codegen(ctx);
 
         if (statement->is_node(node_t::RETURN)
             || statement->is_node(node_t::BREAK)
             || statement->is_node(node_t::CONTINUE)) {
-            ctx->code_block = parent;
+            ctx->operator--();
 
             return value;
         }
     }
 
-    ctx->code_block = parent;
+    ctx->operator--();
 
     return nullptr;
 }
-
-bool CGCodeBlock::allocated(const string &name) {
-    if (variables[name]) return true;
-
-    if (parent == nullptr) return false;
-
-    return parent->allocated(name);
-}
-
-AllocaInst *CGCodeBlock::get_alloca(const string &name) {
-    AllocaInst *variable = variables[name];
-
-    if (variable) return variable;
-
-    if (parent == nullptr) return nullptr;
-
-    return parent->get_alloca(name);
-}
-
-Value *CGCodeBlock::alloc(Context *ctx, const string &name, Type *type) {
-    if (this->allocated(name))
-        fail("Variable <" + name + "> is already allocated");
-
-    variables[name] = ctx->llvm_ir_builder.CreateAlloca(type, nullptr, name);
-
-    unsigned bits = type->getScalarSizeInBits();
-
-    if (bits > 0 && bits % 8 == 0) variables[name]->setAlignment(bits / 8);
-
-    return variables[name];
-}
@@ -31,5 +31,7 @@ Value *CGContinue::codegen(Context *ctx) {
 
     if (!loop_points) fail("Error: Unexpected \"continue\" outside loop");
 
+    ctx->end_scopes(loop_points->depth);
+
     return ctx->llvm_ir_builder.CreateBr(loop_points->continue_point);
 }
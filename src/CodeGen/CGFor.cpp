@@ -24,7 +24,13 @@ using namespace silicon::codegen;
 using namespace silicon::parser::AST;
 
 
-CGFor::CGFor(For *node) : Node{node}, For{node} {
+CGFor::CGFor(For *node) :
+        Node{node},
+        For{node},
+        cg_definition(resolve(definition)),
+        cg_condition(resolve(condition)),
+        cg_stepper(resolve(stepper)),
+        cg_body(resolve(body)) {
 }
 
 Value *CGFor::codegen(Context *ctx) {
@@ -56,9 +62,11 @@ Value *CGFor::codegen(Context *ctx) {
     ctx->llvm_ir_builder.SetInsertPoint(loopBB);
 
     loop_points_t *loop_points = ctx->loop_points;
-    ctx->loop_points = new loop_points_t();
-    ctx->loop_points->break_point = afterBB;
-    ctx->loop_points->continue_point = stepperBB;
+    loop_points_t points;
+    ctx->loop_points = &points;
+    points.break_point = afterBB;
+    points.continue_point = stepperBB;
+    points.depth = ctx->symbols.depth();
 
     llvm::Value *thenV = bodyCodegen(ctx);
     if (!thenV) ctx->llvm_ir_builder.CreateBr(stepperBB);
@@ -72,26 +80,27 @@ Value *CGFor::codegen(Context *ctx) {
 
     ctx->llvm_ir_builder.CreateBr(conditionBB);
 
-    ctx->operator--();
-
     function->getBasicBlockList().push_back(afterBB);
     ctx->llvm_ir_builder.SetInsertPoint(afterBB);
 
+    // The definition lives until the loop is left, every exit goes through afterBB
+    ctx->operator--();
+
     return nullptr;
 }
 
 Value *CGFor::definitionCodegen(Context *ctx) {
-    return dynamic_cast<CGNode *>(definition)->codegen(ctx);
+    return cg_definition->codegen(ctx);
 }
 
 Value *CGFor::conditionCodegen(Context *ctx) {
-    return ctx->cast_type(dynamic_cast<CGNode *>(condition)->codegen(ctx), ctx->bool_type());
+    return ctx->cast_type(cg_condition->codegen(ctx), ctx->bool_type());
 }
 
 Value *CGFor::stepperCodegen(Context *ctx) {
-    return dynamic_cast<CGNode *>(stepper)->codegen(ctx);
+    return cg_stepper->codegen(ctx);
 }
 
 Value *CGFor::bodyCodegen(Context *ctx) {
-    return dynamic_cast<CGNode *>(body)->codegen(ctx);
+    return cg_body->codegen(ctx);
 }
@@ -26,14 +26,20 @@ using namespace silicon::codegen;
 using namespace silicon::parser::AST;
 
 
-CGFunction::CGFunction(Function *node) : Node{node}, Function{node} {
+CGFunction::CGFunction(Function *node) :
+        Node{node},
+        Function{node},
+        cg_prototype(static_cast<CGPrototype *>(resolve(prototype))),
+        cg_body(resolve(body)) {
 }
 
 Value *CGFunction::codegen(Context *ctx) {
-    auto *proto = dynamic_cast<CGPrototype *>(prototype);
+    CGPrototype *proto = cg_prototype;
 
     string name = proto->name;
 
+    TimeScope scope(ctx->time_trace, "CGFunction", name);
+
     llvm::Function *function = ctx->llvm_module->getFunction(name);
 
     if (!function) function = (llvm::Function *) proto->codegen(ctx);
@@ -48,20 +54,46 @@ Value *CGFunction::codegen(Context *ctx) {
 
     ctx->operator++();
 
-    // Record the function arguments in the NamedValues map.
-    for (auto &Arg: function->args()) {
-        auto *alloca = ctx->alloc(Arg.getName(), Arg.getType());
+    if (proto->takes_command_line(ctx)) {
+        // The command line is viewed as a slice of its argc strings at argv
+        Type *type = ctx->slice_type(ctx->string_type());
+
+        llvm::Argument *argc = function->arg_begin();
+
+        Value *slice = UndefValue::get(type);
+
+        slice = ctx->llvm_ir_builder.CreateInsertValue(slice, argc + 1, 0);
+
+        slice = ctx->llvm_ir_builder.CreateInsertValue(
+                slice,
+                ctx->llvm_ir_builder.CreateSExt(argc, ctx->length_type()),
+                1,
+                "arguments"
+        );
 
-        ctx->store(&Arg, alloca);
+        ctx->store(slice, ctx->alloc(proto->arguments[0].first, type));
+    } else {
+        // Record the function arguments in the NamedValues map.
+        for (auto &Arg: function->args()) {
+            auto *alloca = ctx->alloc(Arg.getName(), Arg.getType());
+
+            if (!alloca) fail("Variable <" + Arg.getName().str() + "> is already allocated");
+
+            ctx->mark_unsigned(alloca, ctx->is_unsigned(&Arg));
+
+            ctx->store(&Arg, alloca);
+        }
     }
 
     Type *return_type = proto->get_return_type(ctx);
 
     Type *expected_type = ctx->expected_type;
+    bool expected_unsigned = ctx->expected_unsigned;
 
     ctx->expected_type = return_type;
+    ctx->expected_unsigned = ctx->is_unsigned(function);
 
-    auto *result = (ReturnInst *) dynamic_cast<CGNode *>(body)->codegen(ctx);
+    auto *result = (ReturnInst *) cg_body->codegen(ctx);
 
     if (!result) {
         Type *fnReturnT = function->getReturnType();
@@ -77,6 +109,7 @@ Value *CGFunction::codegen(Context *ctx) {
     // Finish off the function.
 
     ctx->expected_type = expected_type;
+    ctx->expected_unsigned = expected_unsigned;
 
     ctx->operator--();
 
@@ -96,7 +129,11 @@ Value *CGFunction::codegen(Context *ctx) {
     // Validate the generated code, checking for consistency.
     verifyFunction(*function);
 
-    ctx->llvm_fpm->run(*function);
+    if (ctx->llvm_fpm) {
+        TimeScope fpm_scope(ctx->time_trace, "FunctionPassManager", name);
+
+        ctx->llvm_fpm->run(*function);
+    }
 
     return function;
 }
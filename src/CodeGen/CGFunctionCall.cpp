@@ -15,7 +15,9 @@
 //
 
 
+#include "llvm/Analysis/ValueTracking.h"
 #include "silicon/CodeGen/CGFunctionCall.h"
+#include "silicon/CodeGen/CGVariable.h"
 
 
 using namespace std;
@@ -25,9 +27,14 @@ using namespace silicon::parser::AST;
 
 
 CGFunctionCall::CGFunctionCall(FunctionCall *node) : Node{node}, FunctionCall{node} {
+    cg_args.reserve(args.size());
+
+    for (auto &arg: args) cg_args.push_back(resolve(arg));
 }
 
 Value *CGFunctionCall::codegen(Context *ctx) {
+    if (llvm::Value *value = builtin(ctx)) return value;
+
     Function *calleeFunc = ctx->llvm_module->getFunction(callee);
 
     if (!calleeFunc) fail("Error: Undefined function <" + callee + ">");
@@ -36,6 +43,7 @@ Value *CGFunctionCall::codegen(Context *ctx) {
     vector<llvm::Value *> argsV;
 
     llvm::Type *expected_type = ctx->expected_type;
+    bool expected_unsigned = ctx->expected_unsigned;
 
     vector<string> argNames;
     for (auto &arg: calleeFunc->args()) argNames.push_back(arg.getName());
@@ -60,9 +68,14 @@ Value *CGFunctionCall::codegen(Context *ctx) {
         if (i < expected_args_count) ctx->expected_type = calleeType->getFunctionParamType(i);
         else ctx->expected_type = nullptr; // variadic
 
-        Node *arg = args[i];
+        ctx->expected_unsigned = i < expected_args_count && ctx->is_unsigned(calleeFunc->arg_begin() + i);
+
+        CGNode *arg = cg_args[i];
 
-        llvm::Value *value = dynamic_cast<CGNode *>(arg)->codegen(ctx);
+        // Fixed size arrays are passed to slice parameters as a view
+        llvm::Value *value = ctx->expected_type ? ctx->as_slice(arg, ctx->expected_type) : nullptr;
+
+        if (!value) value = arg->codegen(ctx);
 
         if (ctx->expected_type && !ctx->compare_types(value->getType(), ctx->expected_type)) {
             arg->fail(
@@ -79,10 +92,411 @@ Value *CGFunctionCall::codegen(Context *ctx) {
         argsV.push_back(value);
 
         ctx->expected_type = expected_type;
+        ctx->expected_unsigned = expected_unsigned;
 
         if (!argsV.back())
             return nullptr;
     }
 
-    return ctx->llvm_ir_builder.CreateCall(calleeFunc, argsV);
+    // Pure functions called on constants are evaluated here when opted in, their result is baked in as a constant.
+    // Constants can't carry unsignedness, those calls are left to the optimizer.
+    if (ctx->comptime && initializer && !ctx->is_unsigned(calleeFunc)) {
+        SmallVector<Constant *, 8> constants;
+
+        for (auto *value: argsV) {
+            if (auto *constant = dyn_cast<Constant>(value)) constants.push_back(constant);
+        }
+
+        if (constants.size() == argsV.size()) {
+            if (Constant *result = ctx->evaluator.evaluate(calleeFunc, constants)) return result;
+        }
+    }
+
+    CallInst *call = ctx->llvm_ir_builder.CreateCall(calleeFunc, argsV);
+
+    call->setCallingConv(calleeFunc->getCallingConv());
+
+    ctx->mark_unsigned(call, ctx->is_unsigned(calleeFunc));
+
+    llvm::Function *caller = ctx->llvm_ir_builder.GetInsertBlock()->getParent();
+
+    // The frame of the caller is gone during a tail call, arguments must not point into it
+    bool frame_args = any_of(argsV, [ctx](llvm::Value *value) { return points_to_frame(ctx, value); });
+
+    if (tail_position && !frame_args) {
+        // A self-recursive call has the signature and calling convention of its caller, it can reuse its frame.
+        if (calleeFunc == caller && !is_variadic) call->setTailCallKind(CallInst::TCK_MustTail);
+        else call->setTailCall();
+    } else if (calleeFunc == caller && ctx->tail_recursive.count(callee) > 0) {
+        if (tail_position)
+            fail("Error: Recursive call to <" + callee + "> passes local memory, it can't be compiled as a tail call");
+
+        fail("Error: Recursive call to <" + callee + "> is not in tail position, it can't be compiled as a tail call");
+    }
+
+    return call;
+}
+
+Value *CGFunctionCall::get_pointer(Context *ctx) {
+    if (callee != "at" || ctx->llvm_module->getFunction(callee))
+        fail("Can not assign to the result of <" + callee + ">");
+
+    expect_args(2);
+
+    return element_pointer(ctx, 1);
+}
+
+bool CGFunctionCall::points_to_frame(Context *ctx, llvm::Value *value) {
+    // Slices are built field by field
+    if (auto *insert = dyn_cast<InsertValueInst>(value)) {
+        return points_to_frame(ctx, insert->getAggregateOperand())
+               || points_to_frame(ctx, insert->getInsertedValueOperand());
+    }
+
+    // Slices loaded from variables may view an array of the caller
+    if (ctx->is_slice(value->getType())) return !isa<Constant>(value);
+
+    if (!value->getType()->isPointerTy()) return false;
+
+    llvm::Value *object = GetUnderlyingObject(value, ctx->llvm_module->getDataLayout());
+
+    return isa<AllocaInst>(object) || isa<ExtractValueInst>(object);
+}
+
+// alloc(length) allocates a zeroed array on the heap, viewed by the slice type it is assigned to
+Value *CGFunctionCall::alloc(Context *ctx) {
+    expect_args(1);
+
+    llvm::Type *type = ctx->expected_type;
+
+    if (!type || !ctx->is_slice(type))
+        fail("TypeError: Can not infer the slice type of <alloc>, declare the type it is assigned to");
+
+    ctx->expected_type = ctx->length_type();
+
+    llvm::Value *length = cg_args[0]->codegen(ctx);
+
+    ctx->expected_type = type;
+
+    if (!length->getType()->isIntegerTy() || length->getType()->isIntegerTy(1)) {
+        cg_args[0]->fail(
+                "TypeError: Expected the length to be an integer, got <"
+                + ctx->stringify_type(length->getType())
+                + "> instead."
+        );
+    }
+
+    if (ctx->is_unsigned(length)) length = ctx->llvm_ir_builder.CreateZExtOrTrunc(length, ctx->length_type());
+    else length = ctx->llvm_ir_builder.CreateSExtOrTrunc(length, ctx->length_type());
+
+    return ctx->heap_slice(type, length);
+}
+
+// free(slice) releases an array allocated by alloc
+Value *CGFunctionCall::free(Context *ctx) {
+    expect_args(1);
+
+    llvm::Value *slice = cg_args[0]->codegen(ctx);
+
+    CallInst *call = ctx->free_slice(slice);
+
+    if (!call) {
+        cg_args[0]->fail(
+                "TypeError: Expected a slice, got <"
+                + ctx->stringify_type(slice->getType())
+                + "> instead."
+        );
+    }
+
+    return call;
+}
+
+// Builtins are shadowed by functions of the same name
+Value *CGFunctionCall::builtin(Context *ctx) {
+    if (ctx->llvm_module->getFunction(callee)) return nullptr;
+
+    if (callee == "at") return ctx->load(get_pointer(ctx), "element");
+
+    if (callee == "splat") return splat(ctx);
+
+    if (callee == "shuffle") return shuffle(ctx);
+
+    if (callee == "reduce_add" || callee == "reduce_mul" || callee == "reduce_min" || callee == "reduce_max")
+        return reduce(ctx);
+
+    if (callee == "alloc") return alloc(ctx);
+
+    if (callee == "free") return free(ctx);
+
+    if (callee == "select") return select(ctx);
+
+    if (callee == "load") return vector_load(ctx);
+
+    if (callee == "store") return vector_store(ctx);
+
+    return nullptr;
+}
+
+void CGFunctionCall::expect_args(size_t count) {
+    if (args.size() == count) return;
+
+    fail(
+            "Error: Function \""
+            + callee
+            + "\" expected <"
+            + to_string(count)
+            + "> parameter(s), got <"
+            + to_string(args.size())
+            + "> parameter(s) instead."
+    );
+}
+
+// Points to the elements [index, index + count) of `array`, given as the first two arguments
+Value *CGFunctionCall::element_pointer(Context *ctx, unsigned count) {
+    if (!cg_args[0]->is_node(node_t::VARIABLE)) cg_args[0]->fail("TypeError: Expected an array variable");
+
+    auto *array = static_cast<CGVariable *>(cg_args[0]);
+
+    llvm::Value *pointer = array->get_pointer(ctx);
+    llvm::Type *type = array->get_type(ctx);
+
+    if (!ctx->is_array(type)) {
+        array->fail(
+                "TypeError: Expected <"
+                + array->name
+                + "> to be an array, got <"
+                + ctx->stringify_type(type)
+                + "> instead."
+        );
+    }
+
+    llvm::Type *expected_type = ctx->expected_type;
+
+    ctx->expected_type = ctx->length_type();
+
+    llvm::Value *index = cg_args[1]->codegen(ctx);
+
+    ctx->expected_type = expected_type;
+
+    if (!index->getType()->isIntegerTy() || index->getType()->isIntegerTy(1)) {
+        cg_args[1]->fail(
+                "TypeError: Expected the index to be an integer, got <"
+                + ctx->stringify_type(index->getType())
+                + "> instead."
+        );
+    }
+
+    llvm::Value *element = ctx->element_pointer(pointer, type, index, count);
+
+    if (!element) cg_args[1]->fail("Error: Index is out of the bounds of <" + array->name + ">");
+
+    return element;
+}
+
+VectorType *CGFunctionCall::expected_vector(Context *ctx) {
+    auto *vector = dyn_cast_or_null<VectorType>(ctx->expected_type);
+
+    if (!vector) fail("TypeError: Can not infer the vector type of <" + callee + ">, declare the type it is assigned to");
+
+    return vector;
+}
+
+llvm::Value *CGFunctionCall::vector_arg(Context *ctx, unsigned i) {
+    llvm::Value *value = cg_args[i]->codegen(ctx);
+
+    if (!value->getType()->isVectorTy()) {
+        cg_args[i]->fail(
+                "TypeError: Expected a vector, got <"
+                + ctx->stringify_type(value->getType())
+                + "> instead."
+        );
+    }
+
+    return value;
+}
+
+Value *CGFunctionCall::splat(Context *ctx) {
+    expect_args(1);
+
+    VectorType *vector = expected_vector(ctx);
+
+    llvm::Type *expected_type = ctx->expected_type;
+
+    ctx->expected_type = vector->getElementType();
+
+    llvm::Value *value = ctx->cast_type(cg_args[0], vector->getElementType());
+
+    ctx->expected_type = expected_type;
+
+    if (!value) {
+        cg_args[0]->fail(
+                "TypeError: Expected <"
+                + ctx->stringify_type(vector->getElementType())
+                + "> to splat into <"
+                + ctx->stringify_type(vector)
+                + ">"
+        );
+    }
+
+    return ctx->llvm_ir_builder.CreateVectorSplat(vector->getNumElements(), value, "splat");
+}
+
+// shuffle(a, b, lanes...) picks each lane from the concatenation of a and b
+Value *CGFunctionCall::shuffle(Context *ctx) {
+    if (args.size() < 3) fail("Error: Function \"shuffle\" expected two vectors and at least one lane");
+
+    llvm::Value *left = vector_arg(ctx, 0);
+    llvm::Value *right = vector_arg(ctx, 1);
+
+    if (!ctx->compare_types(left, right)) fail("TypeError: Expected both vectors to have the same type.");
+
+    unsigned lanes = left->getType()->getVectorNumElements() * 2;
+
+    SmallVector<uint32_t, 16> mask;
+
+    for (size_t i = 2; i < args.size(); i++) {
+        CGNode *arg = cg_args[i];
+
+        if (!arg->is_node(node_t::NUMBER_LIT)) arg->fail("Error: Expected the lane to be a number literal");
+
+        llvm::Type *expected_type = ctx->expected_type;
+
+        ctx->expected_type = ctx->int_type(32);
+
+        auto *lane = cast<ConstantInt>(arg->codegen(ctx));
+
+        ctx->expected_type = expected_type;
+
+        if (lane->isNegative() || lane->getZExtValue() >= lanes)
+            arg->fail("Error: Lane <" + to_string(lane->getSExtValue()) + "> is out of range");
+
+        mask.push_back(lane->getZExtValue());
+    }
+
+    return ctx->llvm_ir_builder.CreateShuffleVector(left, right, mask, "shuffle");
+}
+
+// select(mask, a, b) takes each lane from a where the mask is set, from b otherwise
+Value *CGFunctionCall::select(Context *ctx) {
+    expect_args(3);
+
+    llvm::Value *mask = vector_arg(ctx, 0);
+
+    if (!mask->getType()->getVectorElementType()->isIntegerTy(1)) {
+        cg_args[0]->fail(
+                "TypeError: Expected a mask, got <"
+                + ctx->stringify_type(mask->getType())
+                + "> instead."
+        );
+    }
+
+    llvm::Value *left = vector_arg(ctx, 1);
+    llvm::Value *right = vector_arg(ctx, 2);
+
+    if (!ctx->compare_types(left, right)) fail("TypeError: Expected both vectors to have the same type.");
+
+    if (left->getType()->getVectorNumElements() != mask->getType()->getVectorNumElements()) {
+        fail(
+                "TypeError: Expected <"
+                + ctx->stringify_type(left->getType())
+                + "> to have as many lanes as <"
+                + ctx->stringify_type(mask->getType())
+                + ">"
+        );
+    }
+
+    return ctx->llvm_ir_builder.CreateSelect(mask, left, right, "select");
+}
+
+Value *CGFunctionCall::reduce(Context *ctx) {
+    expect_args(1);
+
+    llvm::Value *value = vector_arg(ctx, 0);
+
+    llvm::Type *element_type = value->getType()->getVectorElementType();
+
+    if (element_type->isIntegerTy()) {
+        if (callee == "reduce_add") return ctx->llvm_ir_builder.CreateAddReduce(value);
+
+        if (callee == "reduce_mul") return ctx->llvm_ir_builder.CreateMulReduce(value);
+
+        if (callee == "reduce_min") return ctx->llvm_ir_builder.CreateIntMinReduce(value, true);
+
+        return ctx->llvm_ir_builder.CreateIntMaxReduce(value, true);
+    }
+
+    if (callee == "reduce_min") return ctx->llvm_ir_builder.CreateFPMinReduce(value, false);
+
+    if (callee == "reduce_max") return ctx->llvm_ir_builder.CreateFPMaxReduce(value, false);
+
+    CallInst *reduction;
+
+    if (callee == "reduce_add") {
+        reduction = ctx->llvm_ir_builder.CreateFAddReduce(ConstantFP::getNegativeZero(element_type), value);
+    } else {
+        reduction = ctx->llvm_ir_builder.CreateFMulReduce(ConstantFP::get(element_type, 1.0), value);
+    }
+
+    // Lanes are combined in no particular order, a tree instead of a chain
+    FastMathFlags flags;
+    flags.setAllowReassoc();
+    reduction->setFastMathFlags(flags);
+
+    return reduction;
+}
+
+// load(array, index) reads as many elements as the expected vector has lanes
+Value *CGFunctionCall::vector_load(Context *ctx) {
+    expect_args(2);
+
+    VectorType *vector = expected_vector(ctx);
+
+    llvm::Value *pointer = element_pointer(ctx, vector->getNumElements());
+
+    llvm::Type *element_type = pointer->getType()->getPointerElementType();
+
+    if (!ctx->compare_types(element_type, vector->getElementType())) {
+        fail(
+                "TypeError: Can not load <"
+                + ctx->stringify_type(vector)
+                + "> from an array of <"
+                + ctx->stringify_type(element_type)
+                + ">"
+        );
+    }
+
+    LoadInst *load = ctx->load(ctx->llvm_ir_builder.CreateBitCast(pointer, vector->getPointerTo()), "vector");
+
+    load->setAlignment(ctx->llvm_module->getDataLayout().getABITypeAlignment(element_type));
+
+    return load;
+}
+
+// store(array, index, vector) writes every lane starting at index
+Value *CGFunctionCall::vector_store(Context *ctx) {
+    expect_args(3);
+
+    llvm::Value *value = vector_arg(ctx, 2);
+
+    auto *vector = cast<VectorType>(value->getType());
+
+    llvm::Value *pointer = element_pointer(ctx, vector->getNumElements());
+
+    llvm::Type *element_type = pointer->getType()->getPointerElementType();
+
+    if (!ctx->compare_types(element_type, vector->getElementType())) {
+        fail(
+                "TypeError: Can not store <"
+                + ctx->stringify_type(vector)
+                + "> into an array of <"
+                + ctx->stringify_type(element_type)
+                + ">"
+        );
+    }
+
+    StoreInst *store = ctx->store(value, ctx->llvm_ir_builder.CreateBitCast(pointer, vector->getPointerTo()));
+
+    store->setAlignment(ctx->llvm_module->getDataLayout().getABITypeAlignment(element_type));
+
+    return value;
 }
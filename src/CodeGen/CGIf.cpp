@@ -23,7 +23,12 @@ using namespace silicon::codegen;
 using namespace silicon::parser::AST;
 
 
-CGIf::CGIf(If *node) : Node{node}, If{node} {
+CGIf::CGIf(If *node) :
+        Node{node},
+        If{node},
+        cg_condition(resolve(condition)),
+        cg_then(resolve(then_statements)),
+        cg_else(resolve(else_statements)) {
 }
 
 Value *CGIf::codegen(Context *ctx) {
@@ -79,8 +84,8 @@ Value *CGIf::inline_codegen(Context *ctx) {
 
     llvm::Function *function = ctx->llvm_ir_builder.GetInsertBlock()->getParent();
 
-    auto *Then = dynamic_cast<CGNode *>(then_statements);
-    auto *Else = dynamic_cast<CGNode *>(else_statements);
+    auto *Then = cg_then;
+    auto *Else = cg_else;
 
     bool should_keep_then = !Then->is_node(node_t::BOOLEAN_LIT) && !Then->is_node(node_t::NUMBER_LIT);
     bool should_keep_else = !should_keep_then || (!Else->is_node(node_t::BOOLEAN_LIT) && !Else->is_node(node_t::NUMBER_LIT));
@@ -132,13 +137,13 @@ Value *CGIf::inline_codegen(Context *ctx) {
 }
 
 llvm::Value *CGIf::condition_codegen(Context *ctx) {
-    return ctx->cast_type(dynamic_cast<CGNode *>(condition)->codegen(ctx), ctx->bool_type());
+    return ctx->cast_type(cg_condition->codegen(ctx), ctx->bool_type());
 }
 
 llvm::Value *CGIf::then_codegen(Context *ctx) {
-    return dynamic_cast<CGNode *>(then_statements)->codegen(ctx);
+    return cg_then->codegen(ctx);
 }
 
 llvm::Value *CGIf::else_codegen(Context *ctx) {
-    return dynamic_cast<CGNode *>(else_statements)->codegen(ctx);
+    return cg_else->codegen(ctx);
 }
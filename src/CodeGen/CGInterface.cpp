@@ -24,11 +24,19 @@ using namespace silicon::codegen;
 using namespace silicon::parser::AST;
 
 
-CGInterface::CGInterface(Interface *node) : Node{node}, Interface{node} {
+CGInterface::CGInterface(Interface *node) : Node{node}, Interface{node}, symbol(arena->intern(name)) {
+    base_symbols.reserve(bases.size());
+
+    for (const string &base: bases) base_symbols.push_back(arena->intern(base));
+
+    cg_properties.reserve(properties.size());
+
+    for (const auto &property: properties)
+        cg_properties.emplace_back(property.first, static_cast<CGType *>(resolve(property.second)));
 }
 
 Value *CGInterface::codegen(Context *ctx) {
-    vector<pair<string, CGType *>> props = get_properties(ctx);
+    const vector<pair<string, CGType *>> &props = get_properties(ctx);
 
     StructType *type = StructType::create(ctx->llvm_ctx, "interface." + name);
 
@@ -39,32 +47,35 @@ Value *CGInterface::codegen(Context *ctx) {
 
     type->setBody(body);
 
-    ctx->def_interface(name, this);
+    ctx->def_interface(symbol, this, type);
 
-    ctx->def_type(name, type);
+    ctx->def_type(symbol, type);
 
     return nullptr;
 }
 
 uint64_t CGInterface::property_index(Context *ctx, const string &property) {
-    vector<pair<string, CGType *>> props = get_properties(ctx);
-    long index = 0;
+    if (!laid_out) build_layout(ctx);
 
-    for (const auto &prop: props) {
-        if (prop.first == property) return index;
+    auto it = indices.find(property);
 
-        index++;
-    }
+    if (it == indices.end()) return -1;
+
+    return it->second;
+}
+
+const vector<pair<string, CGType *>> &CGInterface::get_properties(Context *ctx) {
+    if (!laid_out) build_layout(ctx);
 
-    return -1;
+    return layout;
 }
 
-vector<pair<string, CGType *>> CGInterface::get_properties(Context *ctx) {
-    vector<pair<string, CGType *>> props{};
-    map<string, bool> names{};
+void CGInterface::build_layout(Context *ctx) {
+    layout.clear();
+    indices.clear();
 
-    for (const string &base: bases) {
-        if (base == name) fail("TypeError: Interface <" + name + "> can't extend itself");
+    for (StringRef base: base_symbols) {
+        if (base.data() == symbol.data()) fail("TypeError: Interface <" + name + "> can't extend itself");
 
         auto *type = ctx->type(base);
 
@@ -75,23 +86,20 @@ vector<pair<string, CGType *>> CGInterface::get_properties(Context *ctx) {
         for (const auto &property: interface->get_properties(ctx)) {
             string property_name = property.first;
 
-            if (names.count(property_name) > 0) fail("Property <" + property_name + "> can not be redefined");
-
-            names[property_name] = true;
+            if (!indices.emplace(property_name, layout.size()).second)
+                fail("Property <" + property_name + "> can not be redefined");
 
-            props.push_back(property);
+            layout.push_back(property);
         }
     }
 
-    for (const auto &property: properties) {
-        string property_name = property.first;
-
-        if (names.count(property_name) > 0) fail("Property <" + property_name + "> can not be redefined");
-
-        names[property_name] = true;
+    // Bases are interfaces looked up by name, only they are left to codegen time
+    for (const auto &property: cg_properties) {
+        if (!indices.emplace(property.first, layout.size()).second)
+            fail("Property <" + property.first + "> can not be redefined");
 
-        props.push_back({property_name, dynamic_cast<CGType *>(property.second)});
+        layout.push_back(property);
     }
 
-    return props;
+    laid_out = true;
 }
@@ -23,7 +23,7 @@ using namespace silicon::codegen;
 using namespace silicon::parser::AST;
 
 
-CGLoop::CGLoop(Loop *node) : Node{node}, Loop{node} {
+CGLoop::CGLoop(Loop *node) : Node{node}, Loop{node}, cg_body(resolve(body)) {
 }
 
 Value *CGLoop::codegen(Context *ctx) {
@@ -38,9 +38,11 @@ Value *CGLoop::codegen(Context *ctx) {
     ctx->llvm_ir_builder.SetInsertPoint(loopBB);
 
     loop_points_t *loop_points = ctx->loop_points;
-    ctx->loop_points = new loop_points_t();
-    ctx->loop_points->break_point = afterBB;
-    ctx->loop_points->continue_point = loopBB;
+    loop_points_t points;
+    ctx->loop_points = &points;
+    points.break_point = afterBB;
+    points.continue_point = loopBB;
+    points.depth = ctx->symbols.depth();
 
     Value *thenV = body_codegen(ctx);
     if (!thenV) ctx->llvm_ir_builder.CreateBr(loopBB);
@@ -54,5 +56,5 @@ Value *CGLoop::codegen(Context *ctx) {
 }
 
 Value *CGLoop::body_codegen(Context *ctx) {
-    return dynamic_cast<CGNode *>(body)->codegen(ctx);
+    return cg_body->codegen(ctx);
 }
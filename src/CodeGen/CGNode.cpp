@@ -20,4 +20,11 @@
 
 using namespace llvm;
 using namespace silicon::codegen;
+using namespace silicon::parser::AST;
 
+
+thread_local Arena *CGNode::arena = nullptr;
+
+CGNode *CGNode::resolve(Node *node) {
+    return dynamic_cast<CGNode *>(node);
+}
@@ -15,6 +15,7 @@
 //
 
 
+#include "llvm/ADT/APInt.h"
 #include "silicon/CodeGen/CGNumberLiteral.h"
 
 
@@ -28,5 +29,33 @@ CGNumberLiteral::CGNumberLiteral(NumberLiteral *node) : Node(node), NumberLitera
 }
 
 Value *CGNumberLiteral::codegen(Context *ctx) {
+    Type *type = ctx->expected_type;
+
+    if (type && type->isVectorTy()) type = type->getVectorElementType();
+
+    // Integer literals take the width and signedness of the expected integer type, i32 otherwise, and have to fit it
+    if (string::npos == value.find('.') && !(type && type->isFloatingPointTy())) {
+        bool is_integer = type && type->isIntegerTy() && type->getIntegerBitWidth() > 1;
+
+        Type *integer_type = is_integer ? type : ctx->llvm_ir_builder.getInt32Ty();
+        unsigned width = integer_type->getIntegerBitWidth();
+
+        APInt number(APInt::getBitsNeeded(value, 10), value, 10);
+
+        // Signed types hold 2^(width - 1) - 1 at most, 2^(width - 1) once negated
+        APInt limit = is_integer && ctx->expected_unsigned ? APInt::getMaxValue(width)
+                      : negated ? APInt::getSignedMinValue(width) : APInt::getSignedMaxValue(width);
+
+        if (number.getActiveBits() > width || number.zextOrTrunc(width).ugt(limit)) {
+            fail(
+                    "TypeError: Number literal <"
+                    + value
+                    + "> does not fit in <"
+                    + ctx->stringify_type(integer_type)
+                    + ">."
+            );
+        }
+    }
+
     return ctx->number_lit(value);
 }
@@ -26,6 +26,9 @@ using namespace silicon::parser::AST;
 
 
 CGPlainObject::CGPlainObject(PlainObject *node) : Node{node}, PlainObject{node} {
+    cg_properties.reserve(properties.size());
+
+    for (auto &property: properties) cg_properties.emplace_back(property.first, resolve(property.second));
 }
 
 Value *CGPlainObject::codegen(Context *ctx) {
@@ -33,41 +36,27 @@ Value *CGPlainObject::codegen(Context *ctx) {
 
     if (!type) fail("TypeError: Can't detect suitable type");
 
-    string type_name = ctx->stringify_type(type);
-
-    if (!ctx->is_interface(type)) fail("TypeError: Can't cast object to type <" + type_name + ">");
+    CGInterface *interface = ctx->interface(type);
 
-    CGInterface *interface = ctx->interface(type_name);
-
-    AllocaInst *var = ctx->llvm_ir_builder.CreateAlloca(type);
+    string type_name = ctx->stringify_type(type);
 
-    unsigned bits = type->getScalarSizeInBits();
+    if (!interface) fail("TypeError: Can't cast object to type <" + type_name + ">");
 
-    if (bits > 0 && bits % 8 == 0) var->setAlignment(bits / 8);
+    AllocaInst *var = ctx->entry_alloca(type);
 
-    map<string, Node *>::iterator it;
+    ctx->lifetime_start(var);
 
     llvm::Type *expected_type = ctx->expected_type;
+    bool expected_unsigned = ctx->expected_unsigned;
 
     for (const auto &property: interface->get_properties(ctx)) {
-        string name = property.first;
-        bool exists = false;
+        const string &name = property.first;
 
-        for (it = properties.begin(); it != properties.end(); it++) {
-            string prop = it->first;
-
-            if (name == prop) {
-                exists = true;
-
-                break;
-            }
-        }
-
-        if (!exists) fail("Error: Property <" + name + "> is missing from interface <" + type_name + ">");
+        if (properties.count(name) == 0) fail("Error: Property <" + name + "> is missing from interface <" + type_name + ">");
     }
 
-    for (it = properties.begin(); it != properties.end(); it++) {
-        string name = it->first;
+    for (const auto &property: cg_properties) {
+        const string &name = property.first;
 
         uint64_t index = interface->property_index(ctx, name);
 
@@ -75,11 +64,17 @@ Value *CGPlainObject::codegen(Context *ctx) {
             fail("Error: Interface <" + type_name + "> has no property named <" + name + ">");
 
         ctx->expected_type = type->getStructElementType(index);
+        ctx->expected_unsigned = interface->get_properties(ctx)[index].second->is_unsigned(ctx);
 
-        ctx->store(dynamic_cast<CGNode *>(it->second)->codegen(ctx), ctx->llvm_ir_builder.CreateStructGEP(var, index));
+        ctx->store(property.second->codegen(ctx), ctx->llvm_ir_builder.CreateStructGEP(var, index));
     }
 
     ctx->expected_type = expected_type;
+    ctx->expected_unsigned = expected_unsigned;
+
+    LoadInst *object = ctx->load(var);
+
+    ctx->lifetime_end(var);
 
-    return ctx->load(var);
+    return object;
 }
@@ -26,16 +26,27 @@ using namespace silicon::codegen;
 using namespace silicon::parser::AST;
 
 
-CGPrototype::CGPrototype(Prototype *node) : Node{node}, Prototype{node} {
+CGPrototype::CGPrototype(Prototype *node) :
+        Node{node},
+        Prototype{node},
+        cg_return_type(static_cast<CGType *>(resolve(return_type))) {
+    cg_argument_types.reserve(arguments.size());
+
+    for (auto &argument: arguments) cg_argument_types.push_back(static_cast<CGType *>(resolve(argument.second)));
 }
 
 Value *CGPrototype::codegen(Context *ctx) {
     vector<string> names;
     vector<llvm::Type *> types;
 
-    for (auto &argument: arguments) {
-        names.push_back(argument.first);
-        types.push_back(dynamic_cast<CGType *>(argument.second)->typegen(ctx));
+    if (takes_command_line(ctx)) {
+        names = {"argc", "argv"};
+        types = {ctx->int_type(32), ctx->string_type()->getPointerTo()};
+    } else {
+        for (size_t i = 0; i < arguments.size(); i++) {
+            names.push_back(arguments[i].first);
+            types.push_back(cg_argument_types[i]->typegen(ctx));
+        }
     }
 
     llvm::Type *result_type = get_return_type(ctx);
@@ -51,14 +62,33 @@ Value *CGPrototype::codegen(Context *ctx) {
 
     llvm::Function *function =
             llvm::Function::Create(function_type, linkage, name, ctx->llvm_module.get());
+
+    // Private functions are only called from this module, they don't have to follow the C calling convention.
+    if (linkage == Function::PrivateLinkage) function->setCallingConv(CallingConv::Fast);
+
+    // Silicon has no exceptions, none of its functions can unwind.
+    if (!is_extern) function->setDoesNotThrow();
     // Set names for all arguments.
 
     unsigned Idx = 0;
-    for (auto &Arg: function->args()) Arg.setName(names[Idx++]);
+    for (auto &Arg: function->args()) {
+        if (Idx < cg_argument_types.size()) ctx->mark_unsigned(&Arg, cg_argument_types[Idx]->is_unsigned(ctx));
+
+        Arg.setName(names[Idx++]);
+    }
+
+    // The function itself stands for its result
+    ctx->mark_unsigned(function, cg_return_type->is_unsigned(ctx));
 
     return function;
 }
 
 llvm::Type *CGPrototype::get_return_type(Context *ctx) {
-    return dynamic_cast<CGType *>(return_type)->typegen(ctx);
+    return cg_return_type->typegen(ctx);
+}
+
+bool CGPrototype::takes_command_line(Context *ctx) {
+    return name == "main"
+           && cg_argument_types.size() == 1
+           && cg_argument_types[0]->typegen(ctx) == ctx->slice_type(ctx->string_type());
 }
@@ -16,6 +16,7 @@
 
 
 #include "silicon/CodeGen/CGReturn.h"
+#include "silicon/CodeGen/CGFunctionCall.h"
 
 
 using namespace llvm;
@@ -23,7 +24,8 @@ using namespace silicon::codegen;
 using namespace silicon::parser::AST;
 
 
-CGReturn::CGReturn(Return *node) : Node{node}, Return{node} {
+CGReturn::CGReturn(Return *node) : Node{node}, Return{node}, cg_value(resolve(value)) {
+    if (cg_value && cg_value->is_node(node_t::FUNCTION_CALL)) static_cast<CGFunctionCall *>(cg_value)->tail_position = true;
 }
 
 Value *CGReturn::codegen(Context *ctx) {
@@ -42,7 +44,7 @@ Value *CGReturn::codegen(Context *ctx) {
         return ret;
     }
 
-    Value *v = dynamic_cast<CGNode *>(value)->codegen(ctx);
+    Value *v = cg_value->codegen(ctx);
 
     ret = ctx->def_return(v);
 
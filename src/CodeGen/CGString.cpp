@@ -24,15 +24,13 @@ using namespace silicon::codegen;
 using namespace silicon::parser::AST;
 
 
-CGString::CGString(String *node) : Node{node}, String{node} {
+CGString::CGString(String *node) : Node{node}, String{node}, symbol(arena->intern(value)) {
 }
 
 Value *CGString::codegen(Context *ctx) {
-    string name = "string." + value;
+    GlobalVariable *&gs = ctx->strings[symbol.data()];
 
-    GlobalVariable *gs = ctx->llvm_module->getNamedGlobal(name);
-
-    if (!gs) gs = ctx->llvm_ir_builder.CreateGlobalString(value, name);
+    if (!gs) gs = ctx->llvm_ir_builder.CreateGlobalString(value, "string");
 
     return ctx->llvm_ir_builder.CreateConstGEP2_64(gs->getValueType(), gs, 0, 0);
 }
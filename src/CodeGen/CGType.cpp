@@ -23,7 +23,11 @@ using namespace silicon::codegen;
 using namespace silicon::parser::AST;
 
 
-CGType::CGType(Type *node) : Node{node}, Type{node} {
+CGType::CGType(Type *node) :
+        Node{node},
+        Type{node},
+        symbol(arena->intern(name)),
+        element_symbol(arena->intern(symbol.split('[').first)) {
 }
 
 Value *CGType::codegen(Context *ctx) {
@@ -31,5 +35,10 @@ Value *CGType::codegen(Context *ctx) {
 }
 
 llvm::Type *CGType::typegen(Context *ctx) {
-    return ctx->type(name);
+    return ctx->type(symbol);
+}
+
+bool CGType::is_unsigned(Context *ctx) {
+    // Arrays and slices of unsigned elements count too
+    return ctx->is_unsigned(element_symbol);
 }
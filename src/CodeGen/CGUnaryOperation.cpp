@@ -15,6 +15,7 @@
 //
 
 
+#include "silicon/CodeGen/CGNumberLiteral.h"
 #include "silicon/CodeGen/CGUnaryOperation.h"
 #include "silicon/CodeGen/CGVariable.h"
 
@@ -25,7 +26,12 @@ using namespace silicon::codegen;
 using namespace silicon::parser::AST;
 
 
-CGUnaryOperation::CGUnaryOperation(UnaryOperation *node) : Node{node}, UnaryOperation{node} {
+CGUnaryOperation::CGUnaryOperation(UnaryOperation *node) :
+        Node{node},
+        UnaryOperation{node},
+        cg_node(resolve(this->node)) {
+    if (op == unary_operation_t::MINUS && cg_node->is_node(node_t::NUMBER_LIT))
+        static_cast<CGNumberLiteral *>(cg_node)->negated = true;
 }
 
 Value *CGUnaryOperation::codegen(Context *ctx) {
@@ -89,7 +95,7 @@ Value *CGUnaryOperation::increment(Context *ctx) {
     if (!node->is_node(node_t::VARIABLE))
         fail("TypeError: Expected variable");
 
-    auto *var = dynamic_cast<CGVariable *>(node);
+    auto *var = static_cast<CGVariable *>(cg_node);
 
     Value *l = var->codegen(ctx);
 
@@ -105,7 +111,9 @@ Value *CGUnaryOperation::increment(Context *ctx) {
 
     Value *operation = nullptr;
 
-    if (type->isIntegerTy()) operation = ctx->llvm_ir_builder.CreateNSWAdd(l, r);
+    if (type->isIntegerTy() && ctx->is_unsigned(l))
+        operation = ctx->mark_unsigned(ctx->llvm_ir_builder.CreateAdd(l, r));
+    else if (type->isIntegerTy()) operation = ctx->llvm_ir_builder.CreateNSWAdd(l, r);
     else if (type->isFloatingPointTy()) operation = ctx->llvm_ir_builder.CreateFAdd(l, r);
 
     if (!operation) unsupported_op(ctx, type);
@@ -121,7 +129,7 @@ Value *CGUnaryOperation::decrement(Context *ctx) {
     if (!node->is_node(node_t::VARIABLE))
         fail("TypeError: Expected variable");
 
-    auto *var = dynamic_cast<CGVariable *>(node);
+    auto *var = static_cast<CGVariable *>(cg_node);
 
     Value *l = var->codegen(ctx);
 
@@ -137,7 +145,9 @@ Value *CGUnaryOperation::decrement(Context *ctx) {
 
     Value *operation = nullptr;
 
-    if (type->isIntegerTy()) operation = ctx->llvm_ir_builder.CreateNSWSub(l, r);
+    if (type->isIntegerTy() && ctx->is_unsigned(l))
+        operation = ctx->mark_unsigned(ctx->llvm_ir_builder.CreateSub(l, r));
+    else if (type->isIntegerTy()) operation = ctx->llvm_ir_builder.CreateNSWSub(l, r);
     else if (type->isFloatingPointTy()) operation = ctx->llvm_ir_builder.CreateFSub(l, r);
 
     if (!operation) unsupported_op(ctx, type);
@@ -150,19 +160,22 @@ Value *CGUnaryOperation::decrement(Context *ctx) {
 }
 
 Value *CGUnaryOperation::negate(Context *ctx) {
-    llvm::Value *n = dynamic_cast<CGNode *>(node)->codegen(ctx);
+    llvm::Value *n = cg_node->codegen(ctx);
 
     llvm::Type *type = n->getType();
 
-    if (type->isIntegerTy()) return ctx->llvm_ir_builder.CreateNSWNeg(n);
+    // Negating an unsigned value wraps around
+    if (type->isIntegerTy() && ctx->is_unsigned(n)) return ctx->mark_unsigned(ctx->llvm_ir_builder.CreateNeg(n));
 
-    if (type->isFloatingPointTy()) return ctx->llvm_ir_builder.CreateFNeg(n);
+    if (type->isIntOrIntVectorTy()) return ctx->llvm_ir_builder.CreateNSWNeg(n);
+
+    if (type->isFPOrFPVectorTy()) return ctx->llvm_ir_builder.CreateFNeg(n);
 
     unsupported_op(ctx, type);
 }
 
 Value *CGUnaryOperation::not_op(Context *ctx) {
-    llvm::Value *value = dynamic_cast<CGNode *>(node)->codegen(ctx);
+    llvm::Value *value = cg_node->codegen(ctx);
 
     llvm::Type *type = value->getType();
 
@@ -25,13 +25,21 @@ using namespace silicon::codegen;
 using namespace silicon::parser::AST;
 
 
-CGVariable::CGVariable(Variable *node) : Node{node}, Variable{node} {
+CGVariable::CGVariable(Variable *node) :
+        Node{node},
+        Variable{node},
+        cg_context(resolve(context)),
+        symbol(arena->intern(name)) {
 }
 
 Value *CGVariable::codegen(Context *ctx) {
-    if (context) return ctx->load(get_pointer(ctx));
+    if (context) {
+        if (Value *length = array_length(ctx)) return length;
+
+        return ctx->load(get_pointer(ctx));
+    }
 
-    auto *alloca = ctx->get_alloca(name);
+    auto *alloca = ctx->get_alloca(symbol);
 
     if (!alloca)
         fail("Variable <" + name + "> is not allocated yet");
@@ -49,17 +57,17 @@ llvm::Type *CGVariable::get_type(Context *ctx) {
     if (context) {
         uint64_t index = element_index(ctx);
 
-        llvm::Type *type = dynamic_cast<CGVariable *>(context)->get_type(ctx);
+        llvm::Type *type = static_cast<CGVariable *>(cg_context)->get_type(ctx);
 
         return type->getStructElementType(index);
     }
 
-    return ctx->get_alloca(name)->getAllocatedType();
+    return ctx->get_alloca(symbol)->getAllocatedType();
 }
 
 Value *CGVariable::get_pointer(Context *ctx) {
     if (!context) {
-        auto *alloca = ctx->get_alloca(name);
+        auto *alloca = ctx->get_alloca(symbol);
 
         if (!alloca)
             fail("Variable <" + name + "> is not allocated yet");
@@ -69,30 +77,44 @@ Value *CGVariable::get_pointer(Context *ctx) {
 
     uint64_t index = element_index(ctx);
 
-    return ctx->llvm_ir_builder.CreateStructGEP(dynamic_cast<CGVariable *>(context)->get_pointer(ctx), index);
+    auto *var = static_cast<CGVariable *>(cg_context);
+
+    Value *pointer = ctx->llvm_ir_builder.CreateStructGEP(var->get_pointer(ctx), index);
+
+    CGInterface *interface = ctx->interface(var->get_type(ctx));
+
+    return ctx->mark_unsigned(pointer, interface->get_properties(ctx)[index].second->is_unsigned(ctx));
+}
+
+Value *CGVariable::array_length(Context *ctx) {
+    if (name != "length" || !context->is_node(node_t::VARIABLE)) return nullptr;
+
+    auto *var = static_cast<CGVariable *>(cg_context);
+
+    llvm::Type *type = var->get_type(ctx);
+
+    if (!ctx->is_array(type)) return nullptr;
+
+    return ctx->array_length(var->get_pointer(ctx), type);
 }
 
 uint64_t CGVariable::element_index(Context *ctx) {
     if (!context->is_node(node_t::VARIABLE))
         fail("Can not access property <" + name + "> of non variable");
 
-    auto *var = dynamic_cast<CGVariable *>(context);
+    auto *var = static_cast<CGVariable *>(cg_context);
 
     llvm::Type *type = var->get_type(ctx);
-    string type_name = ctx->stringify_type(type);
-
-    if (!ctx->is_interface(type))
-        fail("Can not access property <" + name + "> of <" + type_name + ">");
 
-    CGInterface *interface = ctx->interface(type_name);
+    CGInterface *interface = ctx->interface(type);
 
     if (!interface)
-        fail("Can not find interface <" + type_name + ">");
+        fail("Can not access property <" + name + "> of <" + ctx->stringify_type(type) + ">");
 
     uint64_t index = interface->property_index(ctx, name);
 
     if (index == -1)
-        fail("Interface <" + type_name + "> has no property named <" + name + ">");
+        fail("Interface <" + ctx->stringify_type(type) + "> has no property named <" + name + ">");
 
     return index;
 }
@@ -24,17 +24,38 @@ using namespace silicon::codegen;
 using namespace silicon::parser::AST;
 
 
-CGVariableDefinition::CGVariableDefinition(VariableDefinition *node) : Node{node}, VariableDefinition{node} {
+CGVariableDefinition::CGVariableDefinition(VariableDefinition *node) :
+        Node{node},
+        VariableDefinition{node},
+        cg_type(static_cast<CGType *>(resolve(type))) {
 }
 
 Value *CGVariableDefinition::codegen(Context *ctx) {
-    llvm::Type *t = dynamic_cast<CGType *>(type)->typegen(ctx);
+    llvm::Type *t = cg_type->typegen(ctx);
 
     if (!t) t = ctx->expected_type;
 
-    return ctx->alloc(name, t);
+    Value *alloca = ctx->alloc(name, t);
+
+    if (!alloca) fail("Variable <" + name + "> is already allocated");
+
+    ctx->mark_unsigned(alloca, cg_type->is_unsigned(ctx));
+
+    // Arrays have no literal yet, they start zeroed
+    if (t->isArrayTy()) {
+        ctx->llvm_ir_builder.CreateMemSet(
+                alloca,
+                ctx->llvm_ir_builder.getInt8(0),
+                ctx->llvm_module->getDataLayout().getTypeAllocSize(t),
+                static_cast<AllocaInst *>(alloca)->getAlignment()
+        );
+    } else if (ctx->is_slice(t)) {
+        ctx->store(Constant::getNullValue(t), alloca);
+    }
+
+    return alloca;
 }
 
 llvm::Type *CGVariableDefinition::get_type(Context *ctx) {
-    return dynamic_cast<CGType *>(type)->typegen(ctx);
+    return cg_type->typegen(ctx);
 }
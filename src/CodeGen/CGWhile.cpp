@@ -23,7 +23,11 @@ using namespace silicon::codegen;
 using namespace silicon::parser::AST;
 
 
-CGWhile::CGWhile(While *node) : Node{node}, While{node} {
+CGWhile::CGWhile(While *node) :
+        Node{node},
+        While{node},
+        cg_condition(resolve(condition)),
+        cg_body(resolve(body)) {
 }
 
 Value *CGWhile::codegen(Context *ctx) {
@@ -50,9 +54,11 @@ Value *CGWhile::codegen(Context *ctx) {
     ctx->llvm_ir_builder.SetInsertPoint(loopBB);
 
     loop_points_t *loop_points = ctx->loop_points;
-    ctx->loop_points = new loop_points_t();
-    ctx->loop_points->break_point = afterBB;
-    ctx->loop_points->continue_point = conditionBB;
+    loop_points_t points;
+    ctx->loop_points = &points;
+    points.break_point = afterBB;
+    points.continue_point = conditionBB;
+    points.depth = ctx->symbols.depth();
 
     Value *thenV = body_codegen(ctx);
     if (!thenV) ctx->llvm_ir_builder.CreateBr(conditionBB);
@@ -70,9 +76,9 @@ bool CGWhile::has_body() {
 }
 
 Value *CGWhile::condition_codegen(Context *ctx) {
-    return ctx->cast_type(dynamic_cast<CGNode *>(condition)->codegen(ctx), ctx->bool_type());
+    return ctx->cast_type(cg_condition->codegen(ctx), ctx->bool_type());
 }
 
 Value *CGWhile::body_codegen(Context *ctx) {
-    return dynamic_cast<CGNode *>(body)->codegen(ctx);
+    return cg_body->codegen(ctx);
 }
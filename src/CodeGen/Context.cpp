@@ -15,15 +15,21 @@
 //
 
 
-#include <regex>
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Analysis/CFG.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/Transforms/InstCombine/InstCombine.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/IPO/FunctionAttrs.h"
 #include "llvm/Transforms/Scalar.h"
 #include "llvm/Transforms/Scalar/GVN.h"
+#include "llvm/Transforms/Utils.h"
 #include "silicon/CodeGen/Context.h"
 #include "silicon/CodeGen/CGNode.h"
-#include "silicon/CodeGen/CGCodeBlock.h"
 #include "silicon/CodeGen/CGInterface.h"
+#include "silicon/CodeGen/CGVariable.h"
 
 
 using namespace std;
@@ -32,22 +38,51 @@ using namespace silicon;
 using namespace silicon::codegen;
 
 
-Context::Context(const string &library_name) : llvm_ir_builder(llvm_ctx) {
+Context::Context(const string &library_name, optimization_level_t optimization_level) :
+        llvm_ctx_ptr(llvm::make_unique<LLVMContext>()),
+        llvm_ctx(*llvm_ctx_ptr),
+        llvm_ir_builder(llvm_ctx),
+        optimization_level(optimization_level) {
     llvm_module = llvm::make_unique<Module>(library_name, llvm_ctx);
 
-    llvm_fpm = llvm::make_unique<legacy::FunctionPassManager>(llvm_module.get());
-
-    // Do simple "peephole" optimizations and bit-twiddling optzns.
-    llvm_fpm->add(createInstructionCombiningPass());
-    // Reassociate expressions.
-    llvm_fpm->add(createReassociatePass());
-    // Eliminate Common SubExpressions.
-    // TODO: this one seems to slow the executable!
-//    llvm_fpm->add(createGVNPass());
-    // Simplify the control flow graph (deleting unreachable blocks, etc).
-    llvm_fpm->add(createCFGSimplificationPass());
-
-    llvm_fpm->doInitialization();
+    switch (optimization_level) {
+        case optimization_level_t::O0:
+            break;
+        case optimization_level_t::O1:
+            llvm_fpm = llvm::make_unique<legacy::FunctionPassManager>(llvm_module.get());
+
+            // Promote allocas to registers.
+            llvm_fpm->add(createPromoteMemoryToRegisterPass());
+            // Do simple "peephole" optimizations and bit-twiddling optzns.
+            llvm_fpm->add(createInstructionCombiningPass());
+            // Reassociate expressions.
+            llvm_fpm->add(createReassociatePass());
+            // Eliminate Common SubExpressions.
+            // TODO: this one seems to slow the executable!
+//            llvm_fpm->add(createGVNPass());
+            // Simplify the control flow graph (deleting unreachable blocks, etc).
+            llvm_fpm->add(createCFGSimplificationPass());
+            // Turn self-recursive tail calls into loops.
+            llvm_fpm->add(createTailCallEliminationPass());
+            // Canonicalize induction variables, array bounds checks implied by the loop condition fold away.
+            llvm_fpm->add(createIndVarSimplifyPass());
+
+            llvm_fpm->doInitialization();
+            break;
+        default: {
+            llvm_fpm = llvm::make_unique<legacy::FunctionPassManager>(llvm_module.get());
+
+            // The early function simplification pipeline (SROA, EarlyCSE, ...),
+            // the rest of the pipeline runs on the whole module in Context::optimize.
+            PassManagerBuilder builder;
+
+            populate_pass_manager_builder(builder);
+
+            builder.populateFunctionPassManager(*llvm_fpm);
+
+            llvm_fpm->doInitialization();
+        }
+    }
 
     // Types
 
@@ -63,74 +98,275 @@ Context::Context(const string &library_name) : llvm_ir_builder(llvm_ctx) {
     def_type("i64", int_type(64));
     def_type("i128", int_type(128));
 
+    for (unsigned bits: {8, 16, 32, 64, 128}) {
+        string name = "u" + to_string(bits);
+
+        def_type(name, int_type(bits));
+
+        unsigned_types.insert(arena.intern(name).data());
+    }
+
     def_type("f16", float_type(16));
     def_type("f32", float_type(32));
     def_type("f64", float_type(64));
+
+    // SIMD vectors, 128 and 256 bits wide
+
+    def_type("i8x16", vector_type(int_type(8), 16));
+    def_type("i16x8", vector_type(int_type(16), 8));
+    def_type("i32x4", vector_type(int_type(32), 4));
+    def_type("i64x2", vector_type(int_type(64), 2));
+
+    def_type("f32x4", vector_type(float_type(32), 4));
+    def_type("f64x2", vector_type(float_type(64), 2));
+
+    def_type("i8x32", vector_type(int_type(8), 32));
+    def_type("i16x16", vector_type(int_type(16), 16));
+    def_type("i32x8", vector_type(int_type(32), 8));
+    def_type("i64x4", vector_type(int_type(64), 4));
+
+    def_type("f32x8", vector_type(float_type(32), 8));
+    def_type("f64x4", vector_type(float_type(64), 4));
+
+    // Masks, what vector compares yield and select takes, one per lane count above
+
+    for (unsigned lanes: {2, 4, 8, 16, 32}) def_type("boolx" + to_string(lanes), vector_type(bool_type(), lanes));
+}
+
+/* ------------------------- Optimization ------------------------- */
+
+void Context::populate_pass_manager_builder(PassManagerBuilder &builder) {
+    switch (optimization_level) {
+        case optimization_level_t::O0:
+            builder.OptLevel = 0;
+            break;
+        case optimization_level_t::O1:
+            builder.OptLevel = 1;
+            break;
+        case optimization_level_t::O2:
+            builder.OptLevel = 2;
+            break;
+        case optimization_level_t::O3:
+            builder.OptLevel = 3;
+            break;
+        case optimization_level_t::Os:
+            builder.OptLevel = 2;
+            builder.SizeLevel = 1;
+            break;
+    }
+
+    builder.Inliner = createFunctionInliningPass(builder.OptLevel, builder.SizeLevel, false);
+    builder.LoopVectorize = builder.OptLevel > 1 && builder.SizeLevel == 0;
+    builder.SLPVectorize = builder.OptLevel > 1 && builder.SizeLevel == 0;
+}
+
+void Context::infer_attributes() {
+    legacy::PassManager mpm;
+
+    // nounwind, readnone/readonly and norecurse, bottom-up over the call graph.
+    mpm.add(createPostOrderFunctionAttrsLegacyPass());
+    mpm.add(createReversePostOrderFunctionAttrsPass());
+
+    mpm.run(*llvm_module);
+
+    // LLVM doesn't infer willreturn: a function without loops or recursion whose calls all return, returns.
+    bool changed = true;
+
+    while (changed) {
+        changed = false;
+
+        for (llvm::Function &function: *llvm_module) {
+            if (function.isDeclaration()
+                || function.hasFnAttribute(Attribute::WillReturn)
+                || !function.doesNotRecurse())
+                continue;
+
+            SmallVector<pair<const BasicBlock *, const BasicBlock *>, 8> backedges;
+
+            FindFunctionBackedges(function, backedges);
+
+            if (!backedges.empty()) continue;
+
+            bool returns = all_of(instructions(function), [](Instruction &instruction) {
+                auto *call = dyn_cast<CallBase>(&instruction);
+
+                if (!call) return true;
+
+                llvm::Function *callee = call->getCalledFunction();
+
+                if (!callee || callee->doesNotReturn()) return false;
+
+                return callee->isIntrinsic() || callee->hasFnAttribute(Attribute::WillReturn);
+            });
+
+            if (!returns) continue;
+
+            function.addFnAttr(Attribute::WillReturn);
+
+            changed = true;
+        }
+    }
+}
+
+void Context::optimize(TargetMachine *target_machine) {
+    // -O0 only runs the per-function pipeline while generating the IR.
+    if (optimization_level == optimization_level_t::O0) return;
+
+    TimeScope scope(time_trace, "Optimize", llvm_module->getModuleIdentifier());
+
+    infer_attributes();
+
+    if (optimization_level == optimization_level_t::O1) {
+        // Calls to the functions now known to be readnone/readonly can be merged.
+        legacy::PassManager mpm;
+
+        mpm.add(createEarlyCSEPass());
+
+        mpm.run(*llvm_module);
+
+        return;
+    }
+
+    PassManagerBuilder builder;
+
+    populate_pass_manager_builder(builder);
+
+    target_machine->adjustPassManager(builder);
+
+    legacy::PassManager mpm;
+
+    mpm.add(createTargetTransformInfoWrapperPass(target_machine->getTargetIRAnalysis()));
+
+    builder.populateModulePassManager(mpm);
+
+    mpm.run(*llvm_module);
+}
+
+/* ------------------------- Ownership ------------------------- */
+
+orc::ThreadSafeModule Context::release_module() {
+    // The context can't generate any more code once the module and its LLVM context are handed over.
+    llvm_fpm.reset();
+
+    return orc::ThreadSafeModule(std::move(llvm_module), std::move(llvm_ctx_ptr));
 }
 
 /* ------------------------- Blocks ------------------------- */
 
 void Context::operator++() {
-    auto *codeBlock = new CGCodeBlock(new parser::AST::CodeBlock("<virtual>"));
+    symbols.push();
+}
 
-    codeBlock->parent = code_block;
+void Context::operator--() {
+    // Nothing to release when the scope is left through a terminator (return, break, continue),
+    // or outside of any function, as the top-level block of a library without function bodies is.
+    if (BasicBlock *block = llvm_ir_builder.GetInsertBlock(); block && !block->getTerminator()) {
+        for (const auto &symbol: symbols.scope()) lifetime_end(symbol.alloca);
+    }
 
-    code_block = codeBlock;
+    symbols.pop();
 }
 
-void Context::operator--() {
-    code_block = code_block->parent;
+// Branches out of nested scopes (return, break, continue) end the lifetimes of their variables first
+void Context::end_scopes(size_t depth) {
+    for (const auto &symbol: symbols.scopes_below(depth)) lifetime_end(symbol.alloca);
 }
 
 ReturnInst *Context::def_return(Value *value) {
     if (!value) {
         if (expected_type && !compare_types(void_type(), expected_type)) return nullptr;
 
+        end_scopes(0);
+
         return llvm_ir_builder.CreateRetVoid();
     }
 
     if (expected_type && !compare_types(value->getType(), expected_type)) return nullptr;
 
+    end_scopes(0);
+
     return llvm_ir_builder.CreateRet(value);
 }
 
 /* ------------------------- Interfaces ------------------------- */
 
-CGInterface *Context::def_interface(const string &name, CGInterface *interface) {
-    if (interfaces.count(name) > 0) interface->fail("TypeError: Interface <" + name + "> can not be defined again.");
+CGInterface *Context::def_interface(StringRef name, CGInterface *interface, Type *type) {
+    if (!interfaces.try_emplace(name.data(), interface).second)
+        interface->fail("TypeError: Interface <" + name.str() + "> can not be defined again.");
 
-    interfaces.insert({name, interface});
+    type_interfaces.insert({type, interface});
 
     return interface;
 }
 
-CGInterface *Context::interface(const string &name) {
-    auto interface = interfaces.find(name);
+CGInterface *Context::interface(StringRef name) {
+    auto interface = interfaces.find(name.data());
+
+    if (interface == interfaces.end()) return nullptr;
+
+    return interface->second;
+}
+
+CGInterface *Context::interface(Type *type) {
+    auto interface = type_interfaces.find(type);
+
+    if (interface == type_interfaces.end()) return nullptr;
 
     return interface->second;
 }
 
 /* ------------------------- Types ------------------------- */
 
-Type *Context::def_type(const string &name, Type *type) {
+Type *Context::def_type(StringRef name, Type *type) {
     // TODO: fix
 //    if (types.count(name) > 0) fail_codegen("TypeError: Type <" + name + "> can not be defined again.");
 
-    types.insert({name, type});
+    name = arena.intern(name);
+
+    types.insert({name.data(), type});
+
+    type_names.insert({type, name});
 
     return type;
 }
 
-Type *Context::type(const string &name) {
+Type *Context::type(StringRef name) {
     // TODO: fix
 //    if (name.empty()) codegen_error(location, "TypeError: Type <" + name + "> not found.");
 
-    auto type = types.find(name);
+    auto type = types.find(name.data());
+
+    if (type != types.end()) return type->second;
+
+    // Arrays are spelled <element>[<size>], slices <element>[]
+    size_t open = name.rfind('[');
 
     // TODO: fix
 //    if (type == types.end()) codegen_error(location, "TypeError: Type <" + name + "> not found.");
+    if (!name.endswith("]") || open == StringRef::npos) return nullptr;
 
-    return type->second;
+    Type *element_type = this->type(arena.intern(name.substr(0, open)));
+
+    if (!element_type) return nullptr;
+
+    StringRef size = name.slice(open + 1, name.size() - 1);
+
+    Type *array;
+
+    if (size.empty()) {
+        array = slice_type(element_type);
+    } else {
+        uint64_t count;
+
+        if (size.getAsInteger(10, count)) return nullptr;
+
+        array = array_type(element_type, count);
+    }
+
+    // Spellings are resolved once, the next lookup of the same name finds it directly
+    types.insert({name.data(), array});
+
+    return array;
 }
 
 Type *Context::void_type() {
@@ -164,9 +400,61 @@ Type *Context::string_type() {
     return llvm_ir_builder.getInt8PtrTy();
 }
 
+Type *Context::array_type(Type *element_type, uint64_t size) {
+    return ArrayType::get(element_type, size);
+}
+
+// Lengths and default indices are 64 bits wide, arrays may be larger than 2^31 elements
+Type *Context::length_type() {
+    return int_type(64);
+}
+
+Type *Context::vector_type(Type *element_type, unsigned lanes) {
+    return VectorType::get(element_type, lanes);
+}
+
+Type *Context::slice_type(Type *element_type) {
+    StringRef name = arena.intern(stringify_type(element_type) + "[]");
+
+    if (Type *slice = types.lookup(name.data())) return slice;
+
+    // A view over contiguous elements: {data, length}
+    StructType *slice =
+            StructType::create(llvm_ctx, {element_type->getPointerTo(), length_type()}, "slice." + name.str());
+
+    slice_elements[slice] = element_type;
+
+    return def_type(name, slice);
+}
+
 bool Context::is_interface(Type *type) {
-    // TODO: for now
-    return type->isStructTy();
+    return type_interfaces.count(type) > 0;
+}
+
+bool Context::is_slice(Type *type) {
+    return slice_elements.count(type) > 0;
+}
+
+bool Context::is_array(Type *type) {
+    return type->isArrayTy() || is_slice(type);
+}
+
+bool Context::is_unsigned(StringRef type_name) {
+    return unsigned_types.count(type_name.data()) > 0;
+}
+
+bool Context::is_unsigned(const Value *value) {
+    return unsigned_values.count(value) > 0;
+}
+
+Value *Context::mark_unsigned(Value *value, bool is_unsigned) {
+    // Constants are shared, they take the signedness of whatever they are used with
+    if (isa<Constant>(value) && !isa<GlobalValue>(value)) return value;
+
+    if (is_unsigned) unsigned_values.insert({value, true});
+    else unsigned_values.erase(value);
+
+    return value;
 }
 
 bool Context::compare_types(Value *value1, Value *value2) {
@@ -185,6 +473,12 @@ bool Context::compare_types(Type *type1, Type *type2) {
                && compare_types(type1->getArrayElementType(), type2->getArrayElementType());
     }
 
+    if (type1->isVectorTy()) {
+        return type2->isVectorTy()
+               && type1->getVectorNumElements() == type2->getVectorNumElements()
+               && compare_types(type1->getVectorElementType(), type2->getVectorElementType());
+    }
+
     if (type1->isStructTy()) {
         if (!type2->isStructTy()) return false;
 
@@ -215,8 +509,8 @@ bool Context::compare_types(Type *type1, Type *type2) {
 
 Value *Context::cast_type(CGNode *value, Type *type) {
     if (value->is_node(parser::AST::node_t::NUMBER_LIT)
-        && (type->isIntegerTy()
-            || type->isFloatingPointTy())) {
+        && (type->isIntOrIntVectorTy()
+            || type->isFPOrFPVectorTy())) {
         Type *expectedT = expected_type;
 
         expected_type = type;
@@ -231,7 +525,7 @@ Value *Context::cast_type(CGNode *value, Type *type) {
     return cast_type(value->codegen(this), type);
 }
 
-Value *Context::cast_type(Value *value, Type *type) {
+Value *Context::cast_type(Value *value, Type *type, bool is_unsigned) {
     Type *valueT = value->getType();
 
     if (compare_types(valueT, type)) return value;
@@ -247,9 +541,9 @@ Value *Context::cast_type(Value *value, Type *type) {
     return llvm_ir_builder.CreateCast(
             CastInst::getCastOpcode(
                     value,
-                    true, // TODO: handle unsigned too
+                    !this->is_unsigned(value),
                     type,
-                    true // TODO: handle unsigned too
+                    !is_unsigned
             ),
             value,
             type,
@@ -258,13 +552,11 @@ Value *Context::cast_type(Value *value, Type *type) {
 }
 
 string Context::stringify_type(Type *type) {
-    if (type->isStructTy()) {
-        regex re(".*\\.(.*)");
-        cmatch match;
-        regex_match(type->getStructName().str().c_str(), match, re);
+    auto name = type_names.find(type);
 
-        return match[1];
-    }
+    if (name != type_names.end()) return name->second.str();
+
+    if (type->isStructTy()) return type->getStructName().rsplit('.').second.str();
 
     if (type->isVoidTy()) return "void";
 
@@ -285,9 +577,164 @@ string Context::stringify_type(Type *type) {
     if (type->isPointerTy() && type->getPointerElementType()->isIntegerTy(8))
         return "string";
 
+    if (type->isArrayTy())
+        return stringify_type(type->getArrayElementType()) + "[" + to_string(type->getArrayNumElements()) + "]";
+
+    if (type->isVectorTy())
+        return stringify_type(type->getVectorElementType()) + "x" + to_string(type->getVectorNumElements());
+
     return "unknown";
 }
 
+/* ------------------------- Arrays ------------------------- */
+
+Value *Context::array_length(Value *ptr, Type *type) {
+    if (type->isArrayTy()) return int_lit(type->getArrayNumElements(), 64);
+
+    if (!is_slice(type)) return nullptr;
+
+    return load(llvm_ir_builder.CreateStructGEP(ptr, 1), "length");
+}
+
+Value *Context::element_pointer(Value *ptr, Type *type, Value *index, unsigned count) {
+    Value *length = array_length(ptr, type);
+
+    if (!length || !bounds_check(index, length, count)) return nullptr;
+
+    Value *element;
+
+    if (type->isArrayTy()) {
+        element = llvm_ir_builder.CreateInBoundsGEP(type, ptr, {int_lit(0, 32), index}, "element");
+    } else {
+        Value *data = load(llvm_ir_builder.CreateStructGEP(ptr, 0), "data");
+
+        element = llvm_ir_builder.CreateInBoundsGEP(slice_elements[type], data, index, "element");
+    }
+
+    return mark_unsigned(element, is_unsigned(ptr));
+}
+
+Value *Context::as_slice(CGNode *value, Type *type) {
+    auto element_type = slice_elements.find(type);
+
+    if (element_type == slice_elements.end() || !value->is_node(parser::AST::node_t::VARIABLE)) return nullptr;
+
+    auto *variable = static_cast<CGVariable *>(value);
+
+    if (!variable->context && !get_alloca(variable->symbol)) return nullptr;
+
+    Type *valueT = variable->get_type(this);
+
+    if (!valueT->isArrayTy() || !compare_types(valueT->getArrayElementType(), element_type->second)) return nullptr;
+
+    Value *data = llvm_ir_builder.CreateConstInBoundsGEP2_32(valueT, variable->get_pointer(this), 0, 0, "data");
+
+    Value *slice = UndefValue::get(type);
+
+    slice = llvm_ir_builder.CreateInsertValue(slice, data, 0);
+
+    return llvm_ir_builder.CreateInsertValue(slice, int_lit(valueT->getArrayNumElements(), 64), 1, "slice");
+}
+
+bool Context::bounds_check(Value *index, Value *length, unsigned count) {
+    unsigned bits = max(index->getType()->getIntegerBitWidth(), length->getType()->getIntegerBitWidth());
+
+    bool is_unsigned_index = is_unsigned(index);
+
+    if (is_unsigned_index) index = llvm_ir_builder.CreateZExt(index, int_type(bits));
+    else index = llvm_ir_builder.CreateSExt(index, int_type(bits));
+
+    length = llvm_ir_builder.CreateZExt(length, int_type(bits));
+
+    // An unsigned index can't be negative, one compare is enough
+    if (is_unsigned_index && count == 1) {
+        Value *in_bounds = llvm_ir_builder.CreateICmpULT(index, length, "in_bounds");
+
+        if (auto *constant = dyn_cast<ConstantInt>(in_bounds)) return constant->isOne();
+
+        bounds_branch(in_bounds);
+
+        return true;
+    }
+
+    // The last of the elements accessed must fit too
+    if (count > 1) length = llvm_ir_builder.CreateSub(length, ConstantInt::get(length->getType(), count - 1));
+
+    // Signed like the conditions of counted loops, so a dominating `i < length` makes the check redundant
+    Value *in_bounds = llvm_ir_builder.CreateAnd(
+            llvm_ir_builder.CreateICmpSGE(index, ConstantInt::get(index->getType(), 0)),
+            llvm_ir_builder.CreateICmpSLT(index, length),
+            "in_bounds"
+    );
+
+    if (auto *constant = dyn_cast<ConstantInt>(in_bounds)) return constant->isOne();
+
+    bounds_branch(in_bounds);
+
+    return true;
+}
+
+// Arrays whose length is only known at runtime live on the heap, zeroed like fixed size arrays are
+Value *Context::heap_slice(Type *type, Value *length) {
+    auto element_type = slice_elements.find(type);
+
+    if (element_type == slice_elements.end()) return nullptr;
+
+    Type *pointer_type = llvm_ir_builder.getInt8PtrTy();
+    uint64_t size = llvm_module->getDataLayout().getTypeAllocSize(element_type->second);
+
+    FunctionCallee calloc = llvm_module->getOrInsertFunction(
+            "calloc",
+            FunctionType::get(pointer_type, {length_type(), length_type()}, false)
+    );
+
+    Value *memory = llvm_ir_builder.CreateCall(calloc, {length, int_lit(size, 64)}, "memory");
+
+    // A negative length asks for more memory than there is, as does any too large one
+    bounds_branch(llvm_ir_builder.CreateOr(
+            llvm_ir_builder.CreateICmpNE(memory, ConstantPointerNull::get(cast<PointerType>(pointer_type))),
+            llvm_ir_builder.CreateICmpEQ(length, int_lit(0, 64)),
+            "allocated"
+    ));
+
+    Value *data = llvm_ir_builder.CreateBitCast(memory, element_type->second->getPointerTo(), "data");
+
+    Value *slice = UndefValue::get(type);
+
+    slice = llvm_ir_builder.CreateInsertValue(slice, data, 0);
+
+    return llvm_ir_builder.CreateInsertValue(slice, length, 1, "slice");
+}
+
+CallInst *Context::free_slice(Value *slice) {
+    if (!is_slice(slice->getType())) return nullptr;
+
+    FunctionCallee free = llvm_module->getOrInsertFunction(
+            "free",
+            FunctionType::get(void_type(), {llvm_ir_builder.getInt8PtrTy()}, false)
+    );
+
+    Value *data = llvm_ir_builder.CreateExtractValue(slice, 0, "data");
+
+    return llvm_ir_builder.CreateCall(free, llvm_ir_builder.CreateBitCast(data, llvm_ir_builder.getInt8PtrTy()));
+}
+
+void Context::bounds_branch(Value *in_bounds) {
+    llvm::Function *function = llvm_ir_builder.GetInsertBlock()->getParent();
+
+    BasicBlock *failBB = BasicBlock::Create(llvm_ctx, "bounds.fail", function);
+    BasicBlock *okBB = BasicBlock::Create(llvm_ctx, "bounds.ok", function);
+
+    llvm_ir_builder.CreateCondBr(in_bounds, okBB, failBB, MDBuilder(llvm_ctx).createBranchWeights(1 << 20, 1));
+
+    llvm_ir_builder.SetInsertPoint(failBB);
+
+    llvm_ir_builder.CreateCall(Intrinsic::getDeclaration(llvm_module.get(), Intrinsic::trap));
+    llvm_ir_builder.CreateUnreachable();
+
+    llvm_ir_builder.SetInsertPoint(okBB);
+}
+
 /* ------------------------- Literals ------------------------- */
 
 Value *Context::bool_lit(bool value) {
@@ -306,6 +753,23 @@ Value *Context::number_lit(const string &value) {
         return float_lit(value, 64);
     }
 
+    // Literals used with vectors are splatted across the lanes
+    if (expected_type->isVectorTy()) {
+        Type *vector_type = expected_type;
+
+        expected_type = vector_type->getVectorElementType();
+
+        Value *element = number_lit(value);
+
+        expected_type = vector_type;
+
+        return llvm_ir_builder.CreateVectorSplat(vector_type->getVectorNumElements(), element);
+    }
+
+    // Parsed at the full width, unsigned literals may not fit in a long long
+    if (expected_type->isIntegerTy() && string::npos == value.find('.'))
+        return ConstantInt::get(cast<IntegerType>(expected_type), value, 10);
+
     if (expected_type->isIntegerTy()) return int_lit(stoll(value), expected_type->getIntegerBitWidth());
 
     if (expected_type->isFloatingPointTy()) return float_lit(value, expected_type);
@@ -328,14 +792,142 @@ Value *Context::float_lit(const string &value, Type *type) {
     return ConstantFP::get(type, value);
 }
 
+/* ------------------------- Functions ------------------------- */
+
+// Exponentiation by squaring for exponents only known at runtime, one private function per type
+Function *Context::integer_power(IntegerType *type, bool is_unsigned) {
+    string name = (is_unsigned ? "silicon.upow." : "silicon.ipow.") + stringify_type(type);
+
+    if (Function *function = llvm_module->getFunction(name)) return function;
+
+    auto *function = Function::Create(
+            FunctionType::get(type, {type, type}, false),
+            Function::PrivateLinkage,
+            name,
+            llvm_module.get()
+    );
+
+    function->setCallingConv(CallingConv::Fast);
+    function->setDoesNotThrow();
+    function->setDoesNotAccessMemory();
+
+    Argument *base = function->arg_begin();
+    Argument *exponent = function->arg_begin() + 1;
+
+    IRBuilder<> builder(llvm_ctx);
+
+    BasicBlock *entryBB = BasicBlock::Create(llvm_ctx, "entry", function);
+    BasicBlock *loopBB = BasicBlock::Create(llvm_ctx, "loop", function);
+    BasicBlock *stepBB = BasicBlock::Create(llvm_ctx, "step", function);
+    BasicBlock *afterBB = BasicBlock::Create(llvm_ctx, "after", function);
+
+    Constant *zero = ConstantInt::get(type, 0);
+    Constant *one = ConstantInt::get(type, 1);
+
+    builder.SetInsertPoint(entryBB);
+
+    if (!is_unsigned) {
+        // Truncated like division: 1 / x ** n is 0 unless x is 1 or -1
+        BasicBlock *negativeBB = BasicBlock::Create(llvm_ctx, "negative", function, loopBB);
+        BasicBlock *positiveBB = BasicBlock::Create(llvm_ctx, "positive", function, loopBB);
+
+        builder.CreateCondBr(builder.CreateICmpSLT(exponent, zero), negativeBB, positiveBB);
+
+        builder.SetInsertPoint(negativeBB);
+
+        Value *is_unit = builder.CreateOr(
+                builder.CreateICmpEQ(base, one),
+                builder.CreateICmpEQ(base, ConstantInt::getSigned(type, -1))
+        );
+        Value *is_odd = builder.CreateICmpNE(builder.CreateAnd(exponent, one), zero);
+
+        builder.CreateRet(builder.CreateSelect(is_unit, builder.CreateSelect(is_odd, base, one), zero));
+
+        builder.SetInsertPoint(positiveBB);
+    }
+
+    BasicBlock *preBB = builder.GetInsertBlock();
+
+    builder.CreateBr(loopBB);
+
+    builder.SetInsertPoint(loopBB);
+
+    PHINode *result = builder.CreatePHI(type, 2, "result");
+    PHINode *square = builder.CreatePHI(type, 2, "square");
+    PHINode *bits = builder.CreatePHI(type, 2, "bits");
+
+    builder.CreateCondBr(builder.CreateICmpEQ(bits, zero), afterBB, stepBB);
+
+    builder.SetInsertPoint(stepBB);
+
+    Value *is_odd = builder.CreateICmpNE(builder.CreateAnd(bits, one), zero);
+    Value *next_result = builder.CreateSelect(is_odd, builder.CreateMul(result, square), result);
+    Value *next_square = builder.CreateMul(square, square);
+    Value *next_bits = builder.CreateLShr(bits, one);
+
+    builder.CreateBr(loopBB);
+
+    result->addIncoming(one, preBB);
+    result->addIncoming(next_result, stepBB);
+    square->addIncoming(base, preBB);
+    square->addIncoming(next_square, stepBB);
+    bits->addIncoming(exponent, preBB);
+    bits->addIncoming(next_bits, stepBB);
+
+    builder.SetInsertPoint(afterBB);
+
+    builder.CreateRet(result);
+
+    if (llvm_fpm) llvm_fpm->run(*function);
+
+    return function;
+}
+
 /* ------------------------- Memory ------------------------- */
 
-AllocaInst *Context::get_alloca(const string &name) {
-    return code_block->get_alloca(name);
+AllocaInst *Context::get_alloca(StringRef symbol) {
+    return symbols.lookup(symbol);
 }
 
-Value *Context::alloc(const string &name, Type *type) {
-    return code_block->alloc(this, name, type);
+Value *Context::alloc(StringRef name, Type *type) {
+    StringRef symbol = arena.intern(name);
+
+    if (symbols.lookup(symbol)) return nullptr;
+
+    AllocaInst *alloca = entry_alloca(type, name);
+
+    lifetime_start(alloca);
+
+    symbols.define(symbol, alloca);
+
+    return alloca;
+}
+
+AllocaInst *Context::entry_alloca(Type *type, const Twine &name) {
+    // Allocas are always placed at the top of the entry block,
+    // so they are allocated once per call and can be promoted by mem2reg/SROA.
+    BasicBlock &entry = llvm_ir_builder.GetInsertBlock()->getParent()->getEntryBlock();
+
+    IRBuilder<> builder(&entry, entry.begin());
+
+    AllocaInst *alloca = builder.CreateAlloca(type, nullptr, name);
+
+    // Vectors are aligned to their whole size, not to their elements
+    alloca->setAlignment(llvm_module->getDataLayout().getPrefTypeAlignment(type));
+
+    return alloca;
+}
+
+CallInst *Context::lifetime_start(AllocaInst *alloca) {
+    uint64_t size = llvm_module->getDataLayout().getTypeAllocSize(alloca->getAllocatedType());
+
+    return llvm_ir_builder.CreateLifetimeStart(alloca, llvm_ir_builder.getInt64(size));
+}
+
+CallInst *Context::lifetime_end(AllocaInst *alloca) {
+    uint64_t size = llvm_module->getDataLayout().getTypeAllocSize(alloca->getAllocatedType());
+
+    return llvm_ir_builder.CreateLifetimeEnd(alloca, llvm_ir_builder.getInt64(size));
 }
 
 StoreInst *Context::store(Value *value, Value *ptr) {
@@ -343,5 +935,9 @@ StoreInst *Context::store(Value *value, Value *ptr) {
 }
 
 LoadInst *Context::load(Value *ptr, const string &name) {
-    return llvm_ir_builder.CreateLoad(ptr, name);
+    LoadInst *load = llvm_ir_builder.CreateLoad(ptr, name);
+
+    mark_unsigned(load, is_unsigned(ptr));
+
+    return load;
 }
@@ -0,0 +1,502 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#include "llvm/Analysis/ConstantFolding.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Module.h"
+#include "silicon/CodeGen/Evaluator.h"
+
+
+using namespace std;
+using namespace llvm;
+using namespace silicon::codegen;
+
+
+Constant *Evaluator::evaluate(Function *function, ArrayRef<Constant *> args) {
+    if (function->isDeclaration() || function->isVarArg() || function->getReturnType()->isVoidTy()) return nullptr;
+
+    if (args.size() != function->arg_size()) return nullptr;
+
+    data_layout = &function->getParent()->getDataLayout();
+    steps = 0;
+    depth = 0;
+    limited = false;
+
+    Constant *result = nullptr;
+
+    if (!run(function, args, result)) {
+        // Every evaluation starts with the same limits, a call that ran out of them once would again
+        if (limited) failures.insert(make_pair(function, vector<Constant *>(args.begin(), args.end())));
+
+        return nullptr;
+    }
+
+    if (!result || isa<UndefValue>(result)) return nullptr;
+
+    return result;
+}
+
+bool Evaluator::run(Function *function, ArrayRef<Constant *> args, Constant *&result) {
+    auto key = make_pair(function, vector<Constant *>(args.begin(), args.end()));
+
+    auto it = results.find(key);
+
+    if (it != results.end()) {
+        result = it->second;
+
+        return true;
+    }
+
+    if (failures.count(key) > 0) return false;
+
+    if (depth >= max_depth) {
+        limited = true;
+
+        return false;
+    }
+
+    frame_t frame;
+
+    unsigned i = 0;
+    for (auto &arg: function->args()) frame.values[&arg] = args[i++];
+
+    depth++;
+
+    bool success = execute(frame, function, result);
+
+    depth--;
+
+    // A function evaluated before its body is complete may succeed later on, as may one that hit the limits
+    if (success) results[key] = result;
+    else if (!limited && all_of(*function, [](BasicBlock &block) { return block.getTerminator(); }))
+        failures.insert(key);
+
+    return success;
+}
+
+bool Evaluator::execute(frame_t &frame, Function *function, Constant *&result) {
+    BasicBlock *previous = nullptr;
+    BasicBlock *block = &function->getEntryBlock();
+
+    SmallVector<pair<PHINode *, Constant *>, 8> phis;
+
+    while (true) {
+        // A block without terminator is still being generated
+        Instruction *terminator = block->getTerminator();
+
+        if (!terminator) return false;
+
+        // PHIs read the values of the edge taken all at once
+        phis.clear();
+
+        for (auto &phi: block->phis()) {
+            if (!previous) return false;
+
+            Constant *value = get(frame, phi.getIncomingValueForBlock(previous));
+
+            if (!value) return false;
+
+            phis.emplace_back(&phi, value);
+        }
+
+        for (auto &phi: phis) frame.values[phi.first] = phi.second;
+
+        for (auto &inst: *block) {
+            if (isa<PHINode>(inst)) continue;
+
+            if (++steps > max_steps) {
+                limited = true;
+
+                return false;
+            }
+
+            if (&inst == terminator) break;
+
+            if (!step(frame, &inst)) return false;
+        }
+
+        BasicBlock *next = nullptr;
+
+        if (auto *ret = dyn_cast<ReturnInst>(terminator)) {
+            result = nullptr;
+
+            if (ret->getReturnValue()) {
+                result = get(frame, ret->getReturnValue());
+
+                if (!result) return false;
+            }
+
+            return true;
+        } else if (auto *br = dyn_cast<BranchInst>(terminator)) {
+            if (br->isUnconditional()) {
+                next = br->getSuccessor(0);
+            } else {
+                auto *condition = dyn_cast_or_null<ConstantInt>(get(frame, br->getCondition()));
+
+                if (!condition) return false;
+
+                next = br->getSuccessor(condition->isOne() ? 0 : 1);
+            }
+        } else if (auto *sw = dyn_cast<SwitchInst>(terminator)) {
+            auto *condition = dyn_cast_or_null<ConstantInt>(get(frame, sw->getCondition()));
+
+            if (!condition) return false;
+
+            next = sw->findCaseValue(condition)->getCaseSuccessor();
+        } else {
+            return false;
+        }
+
+        previous = block;
+        block = next;
+    }
+}
+
+bool Evaluator::step(frame_t &frame, Instruction *inst) {
+    switch (inst->getOpcode()) {
+        case Instruction::Alloca: {
+            auto *alloca = cast<AllocaInst>(inst);
+
+            if (alloca->isArrayAllocation()) return false;
+
+            slot_t slot;
+            slot.type = alloca->getAllocatedType();
+
+            // Every cell costs a step, large locals are as expensive to set up as they are to fill
+            uint64_t count = count_cells(slot.type);
+
+            if (count > max_steps - steps) {
+                limited = true;
+
+                return false;
+            }
+
+            steps += count;
+            slot.cells.assign(count, nullptr);
+
+            pointer_t pointer;
+            pointer.slot = frame.memory.size();
+            pointer.type = slot.type;
+
+            frame.memory.push_back(move(slot));
+            frame.pointers[inst] = pointer;
+
+            return true;
+        }
+        case Instruction::Load: {
+            auto *load = cast<LoadInst>(inst);
+
+            pointer_t *pointer = get_pointer(frame, load->getPointerOperand());
+
+            if (load->isVolatile() || !pointer || pointer->type != load->getType()) return false;
+
+            Constant *value = build(frame.memory[pointer->slot].cells, pointer->offset, pointer->type);
+
+            if (!value) return false;
+
+            frame.values[inst] = value;
+
+            return true;
+        }
+        case Instruction::Store: {
+            auto *store = cast<StoreInst>(inst);
+
+            pointer_t *pointer = get_pointer(frame, store->getPointerOperand());
+            Constant *value = get(frame, store->getValueOperand());
+
+            if (store->isVolatile() || !pointer || !value || pointer->type != value->getType()) return false;
+
+            return flatten(value, frame.memory[pointer->slot].cells, pointer->offset);
+        }
+        case Instruction::GetElementPtr: {
+            auto *gep = cast<GetElementPtrInst>(inst);
+
+            pointer_t *base = get_pointer(frame, gep->getPointerOperand());
+
+            if (!base || base->type != gep->getSourceElementType()) return false;
+
+            pointer_t pointer = *base;
+            Type *type = pointer.type;
+
+            auto index = gep->idx_begin();
+
+            // Locals are single objects, stepping over them is out of bounds
+            auto *first = dyn_cast_or_null<ConstantInt>(get(frame, *index));
+
+            if (!first || !first->isZero()) return false;
+
+            for (++index; index != gep->idx_end(); ++index) {
+                auto *constant = dyn_cast_or_null<ConstantInt>(get(frame, *index));
+
+                if (!constant || constant->getValue().isNegative() || constant->getValue().getActiveBits() > 32)
+                    return false;
+
+                auto element = (unsigned) constant->getZExtValue();
+
+                if (auto *struct_type = dyn_cast<StructType>(type)) {
+                    if (element >= struct_type->getNumElements()) return false;
+
+                    for (unsigned i = 0; i < element; i++)
+                        pointer.offset += count_cells(struct_type->getElementType(i));
+
+                    type = struct_type->getElementType(element);
+                } else if (auto *array_type = dyn_cast<ArrayType>(type)) {
+                    if (element >= array_type->getNumElements()) return false;
+
+                    type = array_type->getElementType();
+
+                    pointer.offset += element * count_cells(type);
+                } else {
+                    return false;
+                }
+            }
+
+            pointer.type = type;
+
+            frame.pointers[inst] = pointer;
+
+            return true;
+        }
+        case Instruction::BitCast: {
+            pointer_t *base = get_pointer(frame, inst->getOperand(0));
+
+            if (!base) break;
+
+            // Only lifetime markers take casted locals, they can't be read through anymore
+            pointer_t pointer = *base;
+            pointer.type = nullptr;
+
+            frame.pointers[inst] = pointer;
+
+            return true;
+        }
+        case Instruction::Call:
+            return call(frame, cast<CallInst>(inst));
+        case Instruction::ICmp:
+        case Instruction::FCmp: {
+            Constant *left = get(frame, inst->getOperand(0));
+            Constant *right = get(frame, inst->getOperand(1));
+
+            if (!left || !right) return false;
+
+            Constant *value = ConstantFoldCompareInstOperands(
+                    cast<CmpInst>(inst)->getPredicate(), left, right, *data_layout
+            );
+
+            if (!value || isa<UndefValue>(value)) return false;
+
+            frame.values[inst] = value;
+
+            return true;
+        }
+        case Instruction::SDiv:
+        case Instruction::SRem:
+        case Instruction::UDiv:
+        case Instruction::URem: {
+            // Folding would hide the trap
+            auto *divisor = dyn_cast_or_null<ConstantInt>(get(frame, inst->getOperand(1)));
+
+            if (!divisor || divisor->isZero()) return false;
+
+            bool is_signed = inst->getOpcode() == Instruction::SDiv || inst->getOpcode() == Instruction::SRem;
+
+            if (is_signed && divisor->isMinusOne()) {
+                auto *dividend = dyn_cast_or_null<ConstantInt>(get(frame, inst->getOperand(0)));
+
+                if (!dividend || dividend->getValue().isMinSignedValue()) return false;
+            }
+
+            break;
+        }
+        default:
+            break;
+    }
+
+    if (!isa<BinaryOperator>(inst) && !isa<UnaryOperator>(inst) && !isa<CastInst>(inst) && !isa<SelectInst>(inst)
+        && !isa<ExtractValueInst>(inst) && !isa<InsertValueInst>(inst) && !isa<ExtractElementInst>(inst)
+        && !isa<InsertElementInst>(inst) && !isa<ShuffleVectorInst>(inst))
+        return false;
+
+    SmallVector<Constant *, 4> operands;
+
+    for (auto &operand: inst->operands()) {
+        Constant *value = get(frame, operand);
+
+        if (!value) return false;
+
+        operands.push_back(value);
+    }
+
+    Constant *value = ConstantFoldInstOperands(inst, operands, *data_layout);
+
+    if (!value || isa<UndefValue>(value)) return false;
+
+    frame.values[inst] = value;
+
+    return true;
+}
+
+bool Evaluator::call(frame_t &frame, CallInst *inst) {
+    Function *callee = inst->getCalledFunction();
+
+    if (!callee || callee->isVarArg()) return false;
+
+    switch (callee->getIntrinsicID()) {
+        case Intrinsic::lifetime_start:
+        case Intrinsic::lifetime_end:
+        case Intrinsic::dbg_declare:
+        case Intrinsic::dbg_value:
+            return true;
+        case Intrinsic::memset: {
+            // Zeroing a whole local, as array definitions do
+            pointer_t *pointer = get_pointer(frame, inst->getArgOperand(0));
+            auto *value = dyn_cast<ConstantInt>(inst->getArgOperand(1));
+            auto *size = dyn_cast<ConstantInt>(inst->getArgOperand(2));
+
+            if (!pointer || pointer->offset != 0 || !value || !value->isZero() || !size) return false;
+
+            slot_t &slot = frame.memory[pointer->slot];
+
+            if (size->getZExtValue() != data_layout->getTypeAllocSize(slot.type)) return false;
+
+            return flatten(Constant::getNullValue(slot.type), slot.cells, 0);
+        }
+        default:
+            break;
+    }
+
+    SmallVector<Constant *, 8> args;
+
+    for (auto &arg: inst->args()) {
+        Constant *value = get(frame, arg);
+
+        if (!value) return false;
+
+        args.push_back(value);
+    }
+
+    Constant *value = nullptr;
+
+    if (callee->isDeclaration()) {
+        // Only intrinsics and math routines LLVM knows to be pure
+        if (!canConstantFoldCallTo(inst, callee)) return false;
+
+        value = ConstantFoldCall(inst, callee, args);
+
+        if (!value) return false;
+    } else if (!run(callee, args, value)) {
+        return false;
+    }
+
+    if (!inst->getType()->isVoidTy()) {
+        if (!value || isa<UndefValue>(value)) return false;
+
+        frame.values[inst] = value;
+    }
+
+    return true;
+}
+
+Constant *Evaluator::get(frame_t &frame, Value *value) {
+    if (auto *constant = dyn_cast<Constant>(value)) return constant;
+
+    auto it = frame.values.find(value);
+
+    return it == frame.values.end() ? nullptr : it->second;
+}
+
+pointer_t *Evaluator::get_pointer(frame_t &frame, Value *value) {
+    auto it = frame.pointers.find(value);
+
+    return it == frame.pointers.end() ? nullptr : &it->second;
+}
+
+uint64_t Evaluator::count_cells(Type *type) {
+    if (auto *struct_type = dyn_cast<StructType>(type)) {
+        uint64_t count = 0;
+
+        for (Type *element: struct_type->elements()) count += count_cells(element);
+
+        return count;
+    }
+
+    if (auto *array_type = dyn_cast<ArrayType>(type))
+        return array_type->getNumElements() * count_cells(array_type->getElementType());
+
+    return 1;
+}
+
+Constant *Evaluator::build(ArrayRef<Constant *> cells, unsigned offset, Type *type) {
+    if (auto *struct_type = dyn_cast<StructType>(type)) {
+        SmallVector<Constant *, 8> elements;
+
+        for (Type *element_type: struct_type->elements()) {
+            Constant *element = build(cells, offset, element_type);
+
+            if (!element) return nullptr;
+
+            elements.push_back(element);
+            offset += count_cells(element_type);
+        }
+
+        return ConstantStruct::get(struct_type, elements);
+    }
+
+    if (auto *array_type = dyn_cast<ArrayType>(type)) {
+        Type *element_type = array_type->getElementType();
+        auto count = (unsigned) count_cells(element_type);
+
+        SmallVector<Constant *, 8> elements;
+
+        for (uint64_t i = 0; i < array_type->getNumElements(); i++) {
+            Constant *element = build(cells, offset, element_type);
+
+            if (!element) return nullptr;
+
+            elements.push_back(element);
+            offset += count;
+        }
+
+        return ConstantArray::get(array_type, elements);
+    }
+
+    // Null while never written
+    return cells[offset];
+}
+
+bool Evaluator::flatten(Constant *value, MutableArrayRef<Constant *> cells, unsigned offset) {
+    Type *type = value->getType();
+
+    if (!type->isStructTy() && !type->isArrayTy()) {
+        cells[offset] = value;
+
+        return true;
+    }
+
+    auto *struct_type = dyn_cast<StructType>(type);
+    unsigned count = struct_type ? struct_type->getNumElements() : (unsigned) type->getArrayNumElements();
+
+    for (unsigned i = 0; i < count; i++) {
+        Constant *element = value->getAggregateElement(i);
+
+        if (!element || !flatten(element, cells, offset)) return false;
+
+        offset += count_cells(element->getType());
+    }
+
+    return true;
+}
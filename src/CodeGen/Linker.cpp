@@ -0,0 +1,233 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#include <mutex>
+#include "lld/Common/Driver.h"
+#include "lld/Common/ErrorHandler.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/VersionTuple.h"
+#include "llvm/Support/raw_ostream.h"
+#include "silicon/CodeGen/Linker.h"
+
+
+using namespace std;
+using namespace llvm;
+using namespace silicon::codegen;
+
+
+static string multiarch_directory(const Triple &triple) {
+    switch (triple.getArch()) {
+        case Triple::x86_64:
+            return "x86_64-linux-gnu";
+        case Triple::x86:
+            return "i386-linux-gnu";
+        case Triple::aarch64:
+            return "aarch64-linux-gnu";
+        case Triple::arm:
+            return "arm-linux-gnueabihf";
+        case Triple::ppc64le:
+            return "powerpc64le-linux-gnu";
+        case Triple::riscv64:
+            return "riscv64-linux-gnu";
+        default:
+            return triple.getArchName().str() + "-linux-gnu";
+    }
+}
+
+static string dynamic_linker(const Triple &triple) {
+    switch (triple.getArch()) {
+        case Triple::x86_64:
+            return "/lib64/ld-linux-x86-64.so.2";
+        case Triple::x86:
+            return "/lib/ld-linux.so.2";
+        case Triple::aarch64:
+            return "/lib/ld-linux-aarch64.so.1";
+        case Triple::arm:
+            return "/lib/ld-linux-armhf.so.3";
+        case Triple::ppc64le:
+            return "/lib64/ld64.so.2";
+        case Triple::riscv64:
+            return "/lib/ld-linux-riscv64-lp64d.so.1";
+        default:
+            return "";
+    }
+}
+
+static vector<string> library_directories(const Triple &triple) {
+    string multiarch = multiarch_directory(triple);
+
+    vector<string> directories{};
+
+    for (const string &directory: {
+            "/usr/lib/" + multiarch,
+            "/lib/" + multiarch,
+            string("/usr/lib64"),
+            string("/lib64"),
+            string("/usr/lib"),
+            string("/lib"),
+    }) {
+        if (sys::fs::is_directory(directory)) directories.push_back(directory);
+    }
+
+    return directories;
+}
+
+static string find_crt_object(const vector<string> &directories, const string &name) {
+    for (const string &directory: directories) {
+        SmallString<128> path(directory);
+
+        sys::path::append(path, name);
+
+        if (sys::fs::exists(path)) return path.str().str();
+    }
+
+    return "";
+}
+
+// GCC installs crtbegin.o, crtend.o and libgcc in /usr/lib/gcc/<triple>/<version>, the newest one is used
+static string gcc_directory(const Triple &triple) {
+    string multiarch = multiarch_directory(triple);
+
+    string directory;
+    VersionTuple newest;
+
+    for (const char *root: {"/usr/lib/gcc", "/usr/lib64/gcc"}) {
+        error_code EC;
+
+        for (sys::fs::directory_iterator target(root, EC), end; target != end && !EC; target.increment(EC)) {
+            StringRef name = sys::path::filename(target->path());
+
+            if (name != multiarch && !name.startswith(triple.getArchName())) continue;
+
+            error_code version_EC;
+
+            for (sys::fs::directory_iterator it(target->path(), version_EC); it != end && !version_EC;
+                 it.increment(version_EC)) {
+                VersionTuple version;
+
+                // tryParse returns true on failure
+                if (version.tryParse(sys::path::filename(it->path()))) continue;
+
+                if (!directory.empty() && version <= newest) continue;
+
+                if (!sys::fs::exists(it->path() + "/crtbegin.o")) continue;
+
+                directory = it->path();
+                newest = version;
+            }
+        }
+    }
+
+    return directory;
+}
+
+static bool run_elf_linker(const vector<string> &arguments) {
+    // lld keeps its state in globals, links can't overlap
+    static mutex lld_mutex;
+
+    lock_guard<mutex> lock(lld_mutex);
+
+    vector<const char *> args{};
+    args.reserve(arguments.size());
+
+    for (const string &argument: arguments) args.push_back(argument.c_str());
+
+    // lld 9 resets everything but its error count, a failed link would fail every link after it
+    lld::errorHandler().errorCount = 0;
+
+    return lld::elf::link(args, false, errs());
+}
+
+static bool link_elf(const vector<string> &objects, const string &output, const Triple &triple, output_type_t type) {
+    // Every argument is kept alive here, lld only receives pointers to them.
+    vector<string> arguments{"ld.lld", "-o", output};
+
+    if (type == output_type_t::OBJECT) {
+        // Merge the objects into a single relocatable object.
+        arguments.emplace_back("-r");
+
+        for (const string &object: objects) arguments.push_back(object);
+
+        return run_elf_linker(arguments);
+    }
+
+    vector<string> directories = library_directories(triple);
+
+    arguments.emplace_back("--eh-frame-hdr");
+
+    if (type == output_type_t::SHARED_LIBRARY) arguments.emplace_back("-shared");
+    else {
+        string interpreter = dynamic_linker(triple);
+
+        if (!interpreter.empty()) {
+            arguments.emplace_back("--dynamic-linker");
+            arguments.push_back(interpreter);
+        }
+
+        string crt1 = find_crt_object(directories, "crt1.o");
+
+        if (crt1.empty()) {
+            errs() << "Could not find <crt1.o> for target \"" << triple.str() << "\"\n";
+
+            return false;
+        }
+
+        arguments.push_back(crt1);
+    }
+
+    string crti = find_crt_object(directories, "crti.o");
+
+    if (!crti.empty()) arguments.push_back(crti);
+
+    // crtbegin/crtend run the .init_array/.fini_array entries of the objects and define __dso_handle,
+    // which atexit from libc_nonshared.a refers to. Shared libraries take the position independent ones.
+    string gcc = gcc_directory(triple);
+
+    bool shared = type == output_type_t::SHARED_LIBRARY;
+
+    if (!gcc.empty()) arguments.push_back(gcc + (shared ? "/crtbeginS.o" : "/crtbegin.o"));
+
+    if (!gcc.empty()) arguments.push_back("-L" + gcc);
+
+    for (const string &directory: directories) arguments.push_back("-L" + directory);
+
+    for (const string &object: objects) arguments.push_back(object);
+
+    // The C math functions (sqrt, pow, ...) are available to extern declarations like the rest of libc.
+    arguments.emplace_back("-lm");
+    arguments.emplace_back("-lc");
+
+    // 128 bit division and conversions are calls into libgcc
+    if (!gcc.empty()) arguments.emplace_back("-lgcc");
+
+    if (!gcc.empty()) arguments.push_back(gcc + (shared ? "/crtendS.o" : "/crtend.o"));
+
+    string crtn = find_crt_object(directories, "crtn.o");
+
+    if (!crtn.empty()) arguments.push_back(crtn);
+
+    return run_elf_linker(arguments);
+}
+
+bool codegen::link(const vector<string> &objects, const string &output, const Triple &triple, output_type_t type) {
+    if (triple.isOSBinFormatELF()) return link_elf(objects, output, triple, type);
+
+    errs() << "Linking is not supported for target \"" << triple.str() << "\" yet, use \"-c\" to emit an object file\n";
+
+    return false;
+}
@@ -0,0 +1,149 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#include <chrono>
+#include <fstream>
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+#include "silicon/CodeGen/ObjectCache.h"
+
+
+using namespace std;
+using namespace llvm;
+using namespace silicon::codegen;
+
+
+ObjectCache::ObjectCache(string directory, uint64_t max_size) :
+        directory(std::move(directory)),
+        max_size(max_size) {
+    if (auto EC = sys::fs::create_directories(this->directory)) {
+        errs() << "Could not create cache directory: " << EC.message();
+
+        exit(1);
+    }
+
+    load_stats();
+}
+
+string ObjectCache::key(const vector<string> &parts) {
+    SHA1 hasher;
+
+    for (const string &part: parts) {
+        hasher.update(part);
+        // Separate the parts, so ("ab", "c") and ("a", "bc") don't collide.
+        hasher.update(StringRef("\0", 1));
+    }
+
+    return toHex(hasher.final(), true);
+}
+
+bool ObjectCache::fetch(const string &key, const string &object) {
+    string entry = entry_path(key);
+
+    bool hit = sys::fs::exists(entry) && !sys::fs::copy_file(entry, object);
+
+    // Pruning evicts the least recently used entries first. Reading doesn't refresh the access time
+    // on noatime or relatime mounts, so it is set explicitly.
+    if (hit) touch(entry);
+
+    lock_guard<std::mutex> lock(mutex);
+
+    if (hit) hits++;
+    else misses++;
+
+    save_stats();
+
+    return hit;
+}
+
+void ObjectCache::touch(const string &entry) {
+    int fd;
+
+    if (sys::fs::openFileForWrite(entry, fd, sys::fs::CD_OpenExisting)) return;
+
+    sys::fs::setLastAccessAndModificationTime(fd, chrono::system_clock::now());
+    sys::Process::SafelyCloseFileDescriptor(fd);
+}
+
+void ObjectCache::store(const string &key, const string &object) {
+    SmallString<128> temporary;
+
+    // Copy next to the entry first and rename it in place,
+    // so concurrent compilations never observe a partially written entry.
+    if (sys::fs::createUniqueFile(directory + "/tmp-%%%%%%%%.o", temporary)) return;
+
+    if (sys::fs::copy_file(object, temporary) || sys::fs::rename(temporary, entry_path(key))) {
+        sys::fs::remove(temporary);
+
+        return;
+    }
+
+    lock_guard<std::mutex> lock(mutex);
+
+    prune();
+}
+
+void ObjectCache::prune() {
+    CachePruningPolicy policy;
+
+    policy.Interval = chrono::seconds(0);
+    policy.MaxSizeBytes = max_size;
+
+    pruneCache(directory, policy);
+}
+
+uint64_t ObjectCache::size() {
+    uint64_t total = 0;
+    error_code EC;
+
+    for (sys::fs::directory_iterator it(directory, EC), end; it != end && !EC; it.increment(EC)) {
+        if (!sys::path::filename(it->path()).startswith("llvmcache-")) continue;
+
+        uint64_t file_size;
+
+        if (!sys::fs::file_size(it->path(), file_size)) total += file_size;
+    }
+
+    return total;
+}
+
+string ObjectCache::entry_path(const string &key) {
+    // pruneCache only considers files with the "llvmcache-" prefix.
+    return directory + "/llvmcache-" + key;
+}
+
+string ObjectCache::stats_path() {
+    return directory + "/stats";
+}
+
+void ObjectCache::load_stats() {
+    ifstream f(stats_path());
+
+    if (!(f >> hits >> misses)) hits = misses = 0;
+}
+
+void ObjectCache::save_stats() {
+    // Counters are best-effort, concurrent compilations may overwrite each other's updates.
+    ofstream f(stats_path(), ios::trunc);
+
+    f << hits << " " << misses << endl;
+}
@@ -0,0 +1,36 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#include "silicon/CodeGen/Options.h"
+
+
+using namespace std;
+using namespace silicon;
+using namespace silicon::codegen;
+
+
+optimization_level_t codegen::parse_optimization_level(const string &level) {
+    if (level == "0") return optimization_level_t::O0;
+
+    if (level == "2") return optimization_level_t::O2;
+
+    if (level == "3") return optimization_level_t::O3;
+
+    if (level == "s") return optimization_level_t::Os;
+
+    return optimization_level_t::O1;
+}
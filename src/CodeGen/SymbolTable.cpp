@@ -0,0 +1,85 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#include "silicon/CodeGen/SymbolTable.h"
+
+
+using namespace std;
+using namespace llvm;
+using namespace silicon::codegen;
+
+
+uint32_t SymbolTable::id(StringRef symbol) {
+    auto it = ids.try_emplace(symbol.data(), bindings.size());
+
+    if (it.second) bindings.push_back(nullptr);
+
+    return it.first->second;
+}
+
+void SymbolTable::push() {
+    scopes.push_back(symbols.size());
+}
+
+void SymbolTable::pop() {
+    size_t marker = scopes.back();
+
+    scopes.pop_back();
+
+    while (symbols.size() > marker) {
+        symbol_t &symbol = symbols.back();
+
+        bindings[symbol.id] = symbol.shadowed;
+
+        symbols.pop_back();
+    }
+}
+
+size_t SymbolTable::depth() const {
+    return scopes.size();
+}
+
+ArrayRef<symbol_t> SymbolTable::scope() const {
+    if (scopes.empty()) return {};
+
+    return makeArrayRef(symbols).drop_front(scopes.back());
+}
+
+ArrayRef<symbol_t> SymbolTable::scopes_below(size_t depth) const {
+    if (depth >= scopes.size()) return {};
+
+    return makeArrayRef(symbols).drop_front(scopes[depth]);
+}
+
+AllocaInst *SymbolTable::lookup(StringRef symbol) const {
+    auto it = ids.find(symbol.data());
+
+    if (it == ids.end()) return nullptr;
+
+    return bindings[it->second];
+}
+
+void SymbolTable::define(StringRef name, AllocaInst *alloca) {
+    symbol_t symbol;
+    symbol.id = id(name);
+    symbol.alloca = alloca;
+    symbol.shadowed = bindings[symbol.id];
+
+    bindings[symbol.id] = alloca;
+
+    symbols.push_back(symbol);
+}
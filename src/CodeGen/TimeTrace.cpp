@@ -0,0 +1,162 @@
+//
+//   Copyright 2021 Ardalan Amini
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+
+#include <algorithm>
+#include <map>
+#include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
+#include "silicon/CodeGen/TimeTrace.h"
+
+
+using namespace std;
+using namespace llvm;
+using namespace silicon::codegen;
+
+
+TimeTrace::TimeTrace() : start(chrono::steady_clock::now()) {
+}
+
+void TimeTrace::begin(const string &name, const string &detail) {
+    auto now = chrono::steady_clock::now();
+
+    lock_guard<std::mutex> lock(mutex);
+
+    auto id = this_thread::get_id();
+
+    // Threads are numbered in the order they first record an event.
+    if (threads.count(id) == 0) threads.insert({id, threads.size()});
+
+    time_trace_event_t event;
+
+    event.name = name;
+    event.detail = detail;
+    event.thread = threads[id];
+    event.begin = now;
+
+    stacks[id].push_back(event);
+}
+
+void TimeTrace::end() {
+    auto now = chrono::steady_clock::now();
+
+    lock_guard<std::mutex> lock(mutex);
+
+    auto &stack = stacks[this_thread::get_id()];
+
+    time_trace_event_t event = stack.back();
+
+    stack.pop_back();
+
+    event.end = now;
+
+    if (!stack.empty()) stack.back().nested += event.end - event.begin;
+
+    events.push_back(event);
+}
+
+void TimeTrace::write(raw_ostream &os) {
+    lock_guard<std::mutex> lock(mutex);
+
+    json::Array trace_events;
+
+    for (const auto &event: events) {
+        auto begin = chrono::duration_cast<chrono::microseconds>(event.begin - start).count();
+        auto duration = chrono::duration_cast<chrono::microseconds>(event.end - event.begin).count();
+
+        json::Object trace_event{
+                {"ph",   "X"},
+                {"pid",  1},
+                {"tid",  event.thread},
+                {"ts",   begin},
+                {"dur",  duration},
+                {"name", event.name},
+        };
+
+        if (!event.detail.empty()) trace_event["args"] = json::Object{{"detail", event.detail}};
+
+        trace_events.push_back(std::move(trace_event));
+    }
+
+    os << json::Value(json::Object{{"traceEvents", std::move(trace_events)}}) << "\n";
+}
+
+void TimeTrace::summarize(raw_ostream &os) {
+    struct total_t {
+        size_t count = 0;
+        chrono::steady_clock::duration duration{};
+    };
+
+    map<string, total_t> totals;
+
+    lock_guard<std::mutex> lock(mutex);
+
+    // Self time, so nested phases (Parse within Compile) are not counted twice
+    for (const auto &event: events) {
+        auto &total = totals[event.name];
+
+        total.count++;
+        total.duration += event.end - event.begin - event.nested;
+    }
+
+    vector<pair<string, total_t>> rows(totals.begin(), totals.end());
+
+    std::sort(rows.begin(), rows.end(), [](const auto &a, const auto &b) {
+        return a.second.duration > b.second.duration;
+    });
+
+    double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    os << left_justify("Phase", 32)
+       << right_justify("Count", 9)
+       << right_justify("Self (ms)", 15)
+       << right_justify("Percent", 9)
+       << "\n";
+
+    for (const auto &row: rows) {
+        double duration = chrono::duration<double, milli>(row.second.duration).count();
+
+        os << format(
+                "%-32s %8zu %14.3f %7.1f%%\n",
+                row.first.c_str(),
+                row.second.count,
+                duration,
+                elapsed > 0 ? duration * 100 / elapsed : 0
+        );
+    }
+
+    os << left_justify("Wall time", 41) << format("%15.3f\n", elapsed);
+}
+
+double TimeTrace::total(const string &name) {
+    chrono::steady_clock::duration duration{};
+
+    lock_guard<std::mutex> lock(mutex);
+
+    for (const auto &event: events) {
+        if (event.name == name) duration += event.end - event.begin;
+    }
+
+    return chrono::duration<double, milli>(duration).count();
+}
+
+TimeScope::TimeScope(TimeTrace *trace, const string &name, const string &detail) : trace(trace) {
+    if (trace) trace->begin(name, detail);
+}
+
+TimeScope::~TimeScope() {
+    if (trace) trace->end();
+}
@@ -15,16 +15,30 @@
 //
 
 
+#include <chrono>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <set>
 #include <llvm/IR/Verifier.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/TargetRegistry.h>
+#include <llvm/Support/Error.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_os_ostream.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/Threading.h>
 #include <llvm/Target/TargetOptions.h>
 #include <llvm/Target/TargetMachine.h>
+#include <llvm/ADT/StringExtras.h>
 #include <llvm/ADT/Triple.h>
+#include <llvm/CodeGen/ParallelCG.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include "silicon/CodeGen/CGNode.h"
 #include "silicon/CodeGen/CGType.h"
 #include "silicon/CodeGen/CGInterface.h"
@@ -48,9 +62,13 @@
 #include "silicon/CodeGen/CGFunctionCall.h"
 #include "silicon/CodeGen/CGReturn.h"
 #include "silicon/CodeGen/Context.h"
+#include "silicon/CodeGen/Linker.h"
+#include "silicon/CodeGen/ObjectCache.h"
+#include "silicon/CodeGen/TimeTrace.h"
 #include "silicon/CodeGen/codegen.h"
 #include "silicon/parser/Parser.h"
 #include "silicon/parser/AST/Node.h"
+#include "config.h"
 
 
 using namespace std;
@@ -61,7 +79,7 @@ using namespace silicon::parser::AST;
 using namespace silicon::codegen;
 
 
-#define WALK_NODE(NODE, BASE) return new NODE(dynamic_cast<BASE *>(node));
+#define WALK_NODE(NODE, BASE) return CGNode::arena->make<NODE>(dynamic_cast<BASE *>(node));
 
 Node *walker(Node *node) {
     switch (node->node_type()) {
@@ -115,36 +133,233 @@ Node *walker(Node *node) {
     }
 }
 
-void codegen::codegen(string input, string output, bool emit_llvm) {
-    const clock_t begin_time = clock();
-
+string read(const string &input) {
     ifstream f(input);
-    string buffer(istreambuf_iterator<char>(f), {});
 
+    return string(istreambuf_iterator<char>(f), {});
+}
+
+string target_backend(const Triple &triple) {
+    switch (triple.getArch()) {
+        case Triple::x86:
+        case Triple::x86_64:
+            return "X86";
+        case Triple::aarch64:
+        case Triple::aarch64_be:
+            return "AArch64";
+        case Triple::arm:
+        case Triple::armeb:
+        case Triple::thumb:
+        case Triple::thumbeb:
+            return "ARM";
+        case Triple::amdgcn:
+        case Triple::r600:
+            return "AMDGPU";
+        case Triple::bpfel:
+        case Triple::bpfeb:
+            return "BPF";
+        case Triple::hexagon:
+            return "Hexagon";
+        case Triple::lanai:
+            return "Lanai";
+        case Triple::mips:
+        case Triple::mipsel:
+        case Triple::mips64:
+        case Triple::mips64el:
+            return "Mips";
+        case Triple::msp430:
+            return "MSP430";
+        case Triple::nvptx:
+        case Triple::nvptx64:
+            return "NVPTX";
+        case Triple::ppc:
+        case Triple::ppc64:
+        case Triple::ppc64le:
+            return "PowerPC";
+        case Triple::riscv32:
+        case Triple::riscv64:
+            return "RISCV";
+        case Triple::sparc:
+        case Triple::sparcv9:
+        case Triple::sparcel:
+            return "Sparc";
+        case Triple::systemz:
+            return "SystemZ";
+        case Triple::wasm32:
+        case Triple::wasm64:
+            return "WebAssembly";
+        case Triple::xcore:
+            return "XCore";
+        default:
+            return "";
+    }
+}
+
+bool initialize_target(const Triple &triple) {
+    string backend = target_backend(triple);
+    bool initialized = false;
+
+#define LLVM_TARGET(TargetName) \
+    if (backend == #TargetName) { \
+        LLVMInitialize##TargetName##TargetInfo(); \
+        LLVMInitialize##TargetName##Target(); \
+        LLVMInitialize##TargetName##TargetMC(); \
+        initialized = true; \
+    }
+#include "llvm/Config/Targets.def"
+
+#define LLVM_ASM_PRINTER(TargetName) \
+    if (backend == #TargetName) LLVMInitialize##TargetName##AsmPrinter();
+#include "llvm/Config/AsmPrinters.def"
+
+    return initialized;
+}
+
+CGNode *parse(const string &input, const string &buffer) {
     Parser parser(input);
 
     parser.cursor(buffer.c_str());
 
     auto *libraryNode = parser.parse(walker);
 
-    auto *library = dynamic_cast<CGNode *>(libraryNode);
+    return dynamic_cast<CGNode *>(libraryNode);
+}
 
-    codegen::Context ctx(input);
+CodeGenOpt::Level codegen_optimization_level(optimization_level_t optimization_level) {
+    switch (optimization_level) {
+        case optimization_level_t::O0:
+            return CodeGenOpt::None;
+        case optimization_level_t::O1:
+            return CodeGenOpt::Less;
+        case optimization_level_t::O3:
+            return CodeGenOpt::Aggressive;
+        default:
+            return CodeGenOpt::Default;
+    }
+}
 
-    library->codegen(&ctx);
+void generate(codegen::Context &ctx, const string &input, const string &buffer, TargetMachine *target_machine) {
+    CGNode *library;
 
-    verifyModule(*ctx.llvm_module);
+    {
+        TimeScope scope(ctx.time_trace, "Parse", input);
 
-    InitializeAllTargetInfos();
-    InitializeAllTargets();
-    InitializeAllTargetMCs();
-    InitializeAllAsmParsers();
-    InitializeAllAsmPrinters();
+        CGNode::arena = &ctx.arena;
 
-    auto TargetTriple = sys::getProcessTriple();
-    ctx.llvm_module->setTargetTriple(TargetTriple);
+        library = parse(input, buffer);
+
+        CGNode::arena = nullptr;
+    }
+
+    ctx.llvm_module->setTargetTriple(target_machine->getTargetTriple().str());
+    ctx.llvm_module->setDataLayout(target_machine->createDataLayout());
+
+    {
+        TimeScope scope(ctx.time_trace, "IRGen", input);
+
+        library->codegen(&ctx);
+    }
+
+    {
+        TimeScope scope(ctx.time_trace, "Verify", input);
+
+        verifyModule(*ctx.llvm_module);
+    }
+
+    ctx.optimize(target_machine);
+}
+
+// The emitters run on worker threads when several inputs are compiled, errors are returned to the main thread.
+Error emit_object(Module *module, TargetMachine *target_machine, const string &output, TimeTrace *time_trace) {
+    TimeScope scope(time_trace, "Backend", output);
+
+    legacy::PassManager pass;
+
+    auto FileType = TargetMachine::CGFT_ObjectFile;
+
+    error_code EC;
+    raw_fd_ostream dest(output, EC, sys::fs::F_None);
+
+    if (EC) return createStringError(EC, "Could not open file: " + EC.message());
+
+    if (target_machine->addPassesToEmitFile(pass, dest, nullptr, FileType))
+        return createStringError(inconvertibleErrorCode(), "TheTargetMachine can't emit a file of this type");
+
+    pass.run(*module);
+    dest.flush();
+
+    return Error::success();
+}
+
+Expected<vector<string>> emit_partitions(
+        unique_ptr<Module> module,
+        const function<unique_ptr<TargetMachine>()> &create_target_machine,
+        unsigned partitions,
+        TimeTrace *time_trace
+) {
+    TimeScope scope(time_trace, "Backend", to_string(partitions) + " partition(s)");
+
+    vector<string> objects{};
+    vector<unique_ptr<raw_fd_ostream>> streams{};
+    vector<raw_pwrite_stream *> outputs{};
+
+    for (unsigned i = 0; i < partitions; i++) {
+        SmallString<128> temporary;
+        int FD;
+
+        if (auto EC = sys::fs::createTemporaryFile("silicon", "o", FD, temporary)) {
+            for (const string &object: objects) sys::fs::remove(object);
+
+            return createStringError(EC, "Could not create temporary file: " + EC.message());
+        }
+
+        objects.push_back(temporary.str().str());
+
+        streams.push_back(llvm::make_unique<raw_fd_ostream>(FD, true));
+
+        outputs.push_back(streams.back().get());
+    }
+
+    // Each partition is lowered on its own thread, in its own LLVMContext.
+    splitCodeGen(std::move(module), outputs, {}, create_target_machine, TargetMachine::CGFT_ObjectFile);
+
+    return objects;
+}
+
+Expected<string> emit_llvm_ir(Module *module, const string &output) {
+    string path = output + ".ll";
+
+    error_code EC;
+    raw_fd_ostream dest(path, EC, sys::fs::F_None);
+
+    if (EC) return createStringError(EC, "Could not open file: " + EC.message());
+
+    module->print(dest, nullptr);
+
+    return path;
+}
+
+void codegen::codegen(vector<string> inputs, options_t options) {
+    const auto begin_time = chrono::steady_clock::now();
+
+    string output = options.output;
+
+    unique_ptr<TimeTrace> time_trace;
+
+    if (options.time_trace) time_trace = llvm::make_unique<TimeTrace>();
+
+    bool native = options.target.empty();
+
+    auto TargetTriple = native ? sys::getProcessTriple() : Triple::normalize(options.target);
     auto TheTriple = Triple(TargetTriple);
 
+    // Only the backend of the requested target is initialized, not every backend LLVM was built with.
+    if (!initialize_target(TheTriple)) {
+        errs() << "Target \"" << TargetTriple << "\" is not supported by this build of silicon";
+
+        exit(1);
+    }
+
     string Error;
     auto Target = TargetRegistry::lookupTarget(TargetTriple, Error);
 
@@ -154,45 +369,251 @@ void codegen::codegen(string input, string output, bool emit_llvm) {
         exit(1);
     }
 
-    auto CPU = sys::getHostCPUName();
+    string CPU = native ? sys::getHostCPUName().str() : "generic";
     // TODO:
     string FeaturesStr;
 
     TargetOptions opt;
     auto RM = Optional<Reloc::Model>();
-    auto TheTargetMachine =
-            Target->createTargetMachine(TargetTriple, CPU, FeaturesStr, opt, RM);
+    if (options.output_type == output_type_t::SHARED_LIBRARY) RM = Reloc::PIC_;
+    auto create_target_machine = [&]() {
+        return unique_ptr<TargetMachine>(Target->createTargetMachine(
+                TargetTriple,
+                CPU,
+                FeaturesStr,
+                opt,
+                RM,
+                None,
+                codegen_optimization_level(options.optimization_level)
+        ));
+    };
 
-    ctx.llvm_module->setDataLayout(TheTargetMachine->createDataLayout());
+    unsigned jobs = options.jobs;
 
-    legacy::PassManager pass;
+    if (jobs == 0) jobs = heavyweight_hardware_concurrency();
 
-    if (emit_llvm) {
-        pass.run(*ctx.llvm_module);
+    // With several inputs the jobs compile whole files,
+    // a single input is split into partitions for the backend instead.
+    bool single = inputs.size() == 1;
+    unsigned partitions = single ? jobs : 1;
 
-        output += ".ll";
+    unique_ptr<ObjectCache> cache;
 
-        error_code EC;
-        raw_fd_ostream dest(output, EC, sys::fs::F_None);
+    if (!options.cache_directory.empty() && !options.emit_llvm)
+        cache = llvm::make_unique<ObjectCache>(options.cache_directory, options.cache_size);
 
-        if (EC) {
-            errs() << "Could not open file: " << EC.message();
+    auto file_output = [&](const string &input) {
+        if (single) return options.output;
 
-            exit(1);
+        return sys::path::stem(input).str();
+    };
+
+    // Outputs named after their input would overwrite each other, as a/main.si and b/main.si would
+    if (!single && (options.emit_llvm || options.output_type == output_type_t::OBJECT)) {
+        map<string, string> stems;
+
+        for (const string &input: inputs) {
+            auto it = stems.insert({file_output(input), input});
+
+            if (!it.second) {
+                errs() << "Inputs \"" << it.first->second << "\" and \"" << input
+                       << "\" would both be written to \"" << it.first->first << "\"\n";
+
+                exit(1);
+            }
+        }
+    }
+
+    // Every input is compiled by its own Context, LLVMContext and TargetMachine.
+    auto compile = [&](const string &input, const string &object) -> Expected<vector<string>> {
+        TimeScope scope(time_trace.get(), "Compile", input);
+
+        auto TheTargetMachine = create_target_machine();
+
+        string buffer = read(input);
+
+        string key;
+
+        if (cache) {
+            // Sorted, so the order of --tail-recursive doesn't matter
+            set<string> tail_recursive(options.tail_recursive.begin(), options.tail_recursive.end());
+
+            key = ObjectCache::key({
+                    SILICON_VERSION,
+                    LLVM_VERSION_STRING,
+                    TargetTriple,
+                    CPU,
+                    FeaturesStr,
+                    to_string((int) options.optimization_level),
+                    to_string((int) options.output_type),
+                    join(tail_recursive, ","),
+                    to_string(options.comptime),
+                    buffer,
+            });
+
+            TimeScope cache_scope(time_trace.get(), "Cache lookup", key);
+
+            // A cache hit skips parsing, IR generation and the backend entirely.
+            if (cache->fetch(key, object)) return vector<string>{object};
+        }
+
+        codegen::Context ctx(input, options.optimization_level);
+
+        ctx.time_trace = time_trace.get();
+        ctx.tail_recursive.insert(options.tail_recursive.begin(), options.tail_recursive.end());
+        ctx.comptime = options.comptime;
+
+        generate(ctx, input, buffer, TheTargetMachine.get());
+
+        if (options.emit_llvm) {
+            auto path = emit_llvm_ir(ctx.llvm_module.get(), file_output(input));
+
+            if (!path) return path.takeError();
+
+            return vector<string>{*path};
         }
 
-        ctx.llvm_module->print(dest, nullptr);
+        if (partitions <= 1) {
+            if (auto error = emit_object(ctx.llvm_module.get(), TheTargetMachine.get(), object, time_trace.get()))
+                return std::move(error);
+
+            if (cache) cache->store(key, object);
+
+            return vector<string>{object};
+        }
+
+        auto partition_objects = emit_partitions(
+                std::move(ctx.llvm_module),
+                create_target_machine,
+                partitions,
+                time_trace.get()
+        );
+
+        if (!partition_objects) return partition_objects.takeError();
+
+        vector<string> objects = std::move(*partition_objects);
+
+        if (options.output_type != output_type_t::OBJECT && !cache) {
+            // The partitions are linked directly, the single object is not needed.
+            sys::fs::remove(object);
+
+            return objects;
+        }
+
+        TimeScope merge_scope(time_trace.get(), "Merge partitions", object);
+
+        bool merged = link(objects, object, TheTriple, output_type_t::OBJECT);
+
+        for (const string &partition: objects) sys::fs::remove(partition);
+
+        if (!merged) {
+            return createStringError(inconvertibleErrorCode(), "Could not merge the partitions of \"" + input + "\"");
+        }
+
+        if (cache) cache->store(key, object);
+
+        return vector<string>{object};
+    };
+
+    vector<string> object_files(inputs.size());
+
+    if (options.emit_llvm) {
+        // Nothing to link, the IR of each input is written next to the others.
+    } else if (options.output_type == output_type_t::OBJECT) {
+        string extension = TheTriple.getOS() == Triple::Win32 ? ".obj" : ".o";
+
+        for (size_t i = 0; i < inputs.size(); i++) object_files[i] = file_output(inputs[i]) + extension;
     } else {
-        if (TheTriple.getOS() == Triple::Win32) {
-            output += ".obj";
-        } else {
-            output += ".o";
+        for (auto &object: object_files) {
+            SmallString<128> temporary;
+
+            if (auto EC = sys::fs::createTemporaryFile("silicon", "o", temporary)) {
+                errs() << "Could not create temporary file: " << EC.message();
+
+                exit(1);
+            }
+
+            object = temporary.str().str();
+        }
+    }
+
+    vector<vector<string>> results(inputs.size());
+    vector<string> errors(inputs.size());
+
+    auto compile_input = [&](size_t i) {
+        auto result = compile(inputs[i], object_files[i]);
+
+        if (result) results[i] = std::move(*result);
+        else errors[i] = toString(result.takeError());
+    };
+
+    if (single) compile_input(0);
+    else {
+        ThreadPool pool(min<size_t>(jobs, inputs.size()));
+
+        for (size_t i = 0; i < inputs.size(); i++) pool.async([&, i]() { compile_input(i); });
+
+        pool.wait();
+    }
+
+    // Workers only record their errors, the process exits here once every job is done
+    if (any_of(errors.begin(), errors.end(), [](const string &error) { return !error.empty(); })) {
+        for (const string &error: errors) {
+            if (!error.empty()) errs() << error << "\n";
+        }
+
+        // Objects that were going to be linked are temporaries
+        if (!options.emit_llvm && options.output_type != output_type_t::OBJECT) {
+            for (const string &object: object_files) sys::fs::remove(object);
+
+            for (const auto &result: results) {
+                for (const string &object: result) sys::fs::remove(object);
+            }
         }
 
-        auto FileType = TargetMachine::CGFT_ObjectFile;
+        exit(1);
+    }
+
+    vector<string> outputs{};
+
+    if (options.emit_llvm || options.output_type == output_type_t::OBJECT) {
+        for (const auto &result: results) outputs.insert(outputs.end(), result.begin(), result.end());
+    } else {
+        if (options.output_type == output_type_t::SHARED_LIBRARY) output += ".so";
+
+        vector<string> objects{};
+
+        for (const auto &result: results) objects.insert(objects.end(), result.begin(), result.end());
+
+        TimeScope scope(time_trace.get(), "Link", output);
+
+        bool linked = link(objects, output, TheTriple, options.output_type);
+
+        for (const string &object: objects) sys::fs::remove(object);
+
+        if (!linked) exit(1);
+
+        outputs.push_back(output);
+    }
+
+    llvm_shutdown();
+
+    const auto end_time = chrono::steady_clock::now();
+
+    for (const string &file: outputs) {
+        cout << "Created \""
+             << file
+             << "\" in "
+             << chrono::duration<double>(end_time - begin_time).count()
+             << " second(s)"
+             << endl;
+    }
+
+    if (time_trace) {
+        string trace_output = options.output + ".time-trace.json";
 
         error_code EC;
-        raw_fd_ostream dest(output, EC, sys::fs::F_None);
+        raw_fd_ostream dest(trace_output, EC, sys::fs::F_None);
 
         if (EC) {
             errs() << "Could not open file: " << EC.message();
@@ -200,24 +621,135 @@ void codegen::codegen(string input, string output, bool emit_llvm) {
             exit(1);
         }
 
-        if (TheTargetMachine->addPassesToEmitFile(pass, dest, nullptr, FileType)) {
-            errs() << "TheTargetMachine can't emit a file of this type";
+        time_trace->write(dest);
 
-            exit(1);
-        }
+        // Through cout, the rest of the output goes there and outs() is buffered separately
+        raw_os_ostream summary(cout);
+
+        time_trace->summarize(summary);
+        summary.flush();
 
-        pass.run(*ctx.llvm_module);
-        dest.flush();
+        cout << "Created \"" << trace_output << "\"" << endl;
     }
+}
 
-    llvm_shutdown();
+int codegen::run(string input, options_t options, vector<string> arguments) {
+    InitializeNativeTarget();
+    InitializeNativeTargetAsmPrinter();
+
+    auto JTMB = orc::JITTargetMachineBuilder::detectHost();
+
+    if (!JTMB) {
+        errs() << toString(JTMB.takeError());
+
+        exit(1);
+    }
+
+    JTMB->setCodeGenOptLevel(codegen_optimization_level(options.optimization_level));
+
+    auto TheTargetMachine = JTMB->createTargetMachine();
+
+    if (!TheTargetMachine) {
+        errs() << toString(TheTargetMachine.takeError());
+
+        exit(1);
+    }
+
+    // Functions are compiled lazily, on their first call.
+    auto JIT = orc::LLLazyJITBuilder()
+            .setJITTargetMachineBuilder(std::move(*JTMB))
+            .create();
+
+    if (!JIT) {
+        errs() << toString(JIT.takeError());
+
+        exit(1);
+    }
+
+    const DataLayout &DL = (*JIT)->getDataLayout();
+
+    (*JIT)->getMainJITDylib().setGenerator(
+            cantFail(orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(DL.getGlobalPrefix()))
+    );
+
+    codegen::Context ctx(input, options.optimization_level);
+
+    ctx.tail_recursive.insert(options.tail_recursive.begin(), options.tail_recursive.end());
+    ctx.comptime = options.comptime;
+
+    generate(ctx, input, read(input), TheTargetMachine->get());
+
+    if (auto Err = (*JIT)->addLazyIRModule(ctx.release_module())) {
+        errs() << toString(std::move(Err));
+
+        exit(1);
+    }
+
+    auto MainSymbol = (*JIT)->lookup("main");
+
+    if (!MainSymbol) {
+        errs() << toString(MainSymbol.takeError());
+
+        exit(1);
+    }
 
-    const clock_t end_time = clock();
+    auto *Main = (int (*)(int, char **)) MainSymbol->getAddress();
 
-    cout << "Created \""
-         << output
-         << "\" in "
-         << double(end_time - begin_time) / CLOCKS_PER_SEC
-         << " second(s)"
-         << endl;
+    vector<char *> argv{};
+    argv.reserve(arguments.size() + 2);
+
+    argv.push_back(input.data());
+
+    for (string &argument: arguments) argv.push_back(argument.data());
+
+    argv.push_back(nullptr);
+
+    return Main((int) arguments.size() + 1, argv.data());
+}
+
+void codegen::compile(
+        const string &input,
+        const string &buffer,
+        const string &object,
+        const options_t &options,
+        TimeTrace *time_trace
+) {
+    InitializeNativeTarget();
+    InitializeNativeTargetAsmPrinter();
+
+    auto TargetTriple = sys::getProcessTriple();
+
+    string Error;
+    auto Target = TargetRegistry::lookupTarget(TargetTriple, Error);
+
+    if (!Target) {
+        errs() << Error;
+
+        exit(1);
+    }
+
+    TargetOptions opt;
+    unique_ptr<TargetMachine> TheTargetMachine(Target->createTargetMachine(
+            TargetTriple,
+            sys::getHostCPUName(),
+            "",
+            opt,
+            Optional<Reloc::Model>(),
+            None,
+            codegen_optimization_level(options.optimization_level)
+    ));
+
+    codegen::Context ctx(input, options.optimization_level);
+
+    ctx.time_trace = time_trace;
+    ctx.tail_recursive.insert(options.tail_recursive.begin(), options.tail_recursive.end());
+    ctx.comptime = options.comptime;
+
+    generate(ctx, input, buffer, TheTargetMachine.get());
+
+    if (auto error = emit_object(ctx.llvm_module.get(), TheTargetMachine.get(), object, time_trace)) {
+        errs() << toString(std::move(error));
+
+        exit(1);
+    }
 }
@@ -17,8 +17,10 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 #include "config.h"
 #include "utils/CLI11.hpp"
+#include "silicon/CodeGen/ObjectCache.h"
 #include "silicon/CodeGen/codegen.h"
 
 
@@ -41,34 +43,167 @@ int main(int argc, char **argv) {
             "Print version info and exit"
     );
 
-    string input;
+    vector<string> inputs;
     app.add_option(
                     "input",
-                    input
+                    inputs
             )
             ->type_name("file")
-            ->check(CLI::ExistingFile)
-            ->required();
+            ->check(CLI::ExistingFile);
+
+    options_t options;
 
-    string output = "output";
     app.add_option(
                     "-o,--output",
-                    output,
+                    options.output,
                     "Write output to <filename>",
                     true
             )
             ->type_name("filename");
 
-    bool emit_llvm = false;
+    app.add_option(
+                    "--target",
+                    options.target,
+                    "Generate code for the given target triple instead of the host"
+            )
+            ->type_name("triple");
+
     app.add_flag(
             "--emit-llvm",
-            emit_llvm,
+            options.emit_llvm,
             "Emit LLVM IR"
     );
 
+    bool compile_only = false;
+    app.add_flag(
+            "-c",
+            compile_only,
+            "Only compile, write an object file instead of linking"
+    );
+
+    bool shared = false;
+    app.add_flag(
+            "--shared",
+            shared,
+            "Link a shared library instead of an executable"
+    );
+
+    string optimization_level = "1";
+    app.add_option(
+                    "-O",
+                    optimization_level,
+                    "Optimization level",
+                    true
+            )
+            ->type_name("level")
+            ->check(CLI::IsMember({"0", "1", "2", "3", "s"}));
+
+    app.add_option(
+                    "-j,--jobs",
+                    options.jobs,
+                    "Number of threads compiling the inputs, or lowering a single input to machine code (0 = all cores)",
+                    true
+            )
+            ->type_name("N");
+
+    app.add_flag(
+            "--time-trace",
+            options.time_trace,
+            "Write a Chrome trace of the compilation phases to <output>.time-trace.json and print a summary"
+    );
+
+    app.add_option(
+                    "--cache-dir",
+                    options.cache_directory,
+                    "Reuse object files of identical compilations from <directory>"
+            )
+            ->type_name("directory");
+
+    app.add_option(
+                    "--cache-size",
+                    options.cache_size,
+                    "Maximum size of the object cache in bytes",
+                    true
+            )
+            ->type_name("bytes");
+
+    bool cache_stats = false;
+    app.add_flag(
+            "--cache-stats",
+            cache_stats,
+            "Print the object cache statistics"
+    );
+
+    app.add_flag(
+            "--comptime",
+            options.comptime,
+            "Evaluate calls with constant arguments that initialize variables at compile time"
+    );
+
+    app.add_option(
+                    "--tail-recursive",
+                    options.tail_recursive,
+                    "Fail unless every recursive call of <function> is a guaranteed tail call"
+            )
+            ->type_name("function");
+
+    auto *run_command = app.add_subcommand(
+                    "run",
+                    "Compile the input in memory and run its main function"
+            )
+            ->fallthrough();
+
+    string input;
+    run_command->add_option(
+                    "input",
+                    input
+            )
+            ->type_name("file")
+            ->check(CLI::ExistingFile)
+            ->required();
+
+    vector<string> arguments;
+    run_command->add_option(
+                    "arguments",
+                    arguments,
+                    "Arguments passed to the program"
+            )
+            ->type_name("argument");
+
     CLI11_PARSE(app, argc, argv);
 
-    codegen(input, output, emit_llvm);
+    options.optimization_level = parse_optimization_level(optimization_level);
+
+    if (compile_only) options.output_type = output_type_t::OBJECT;
+    else if (shared) options.output_type = output_type_t::SHARED_LIBRARY;
+
+    if (*run_command) return run(input, options, arguments);
+
+    if (cache_stats) {
+        if (options.cache_directory.empty()) return app.exit(CLI::RequiredError("--cache-dir"));
+
+        ObjectCache cache(options.cache_directory, options.cache_size);
+
+        cout << "Object cache \""
+             << options.cache_directory
+             << "\": "
+             << cache.hits
+             << " hit(s), "
+             << cache.misses
+             << " miss(es), "
+             << cache.size()
+             << " byte(s)"
+             << endl;
+
+        if (inputs.empty()) return 0;
+    }
+
+    if (inputs.empty()) return app.exit(CLI::RequiredError("input"));
+
+    if (inputs.size() > 1 && options.output_type == output_type_t::OBJECT && app.count("--output") > 0)
+        return app.exit(CLI::ValidationError("--output", "can not be used with -c and multiple inputs"));
+
+    codegen(inputs, options);
 
     return 0;
 }